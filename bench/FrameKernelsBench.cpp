@@ -0,0 +1,155 @@
+#include "FrameKernels.h"
+#include "FixedFrameKernels.h"
+#include "WindowFunction.h"
+#include "BandLayout.h"
+#include <fftw3.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+// Per-frame cost of the generic frame kernels against the fixed-size
+// specializations, for the deployed FFT size / band count pairs. Times each
+// stage of the analyzer's frame path (window, spectrum with the peak scan,
+// band sums) and the whole frame with the FFT, on noise.
+
+namespace {
+    constexpr int kSampleRate = 48000;
+    constexpr int kSamples = 1000;  // Timed runs per path; generic and fixed alternate, so load changes hit both
+    constexpr int kCalls = 16;      // Per timed run, short enough that most runs see no preemption
+
+    // Analyzer defaults for the peak list
+    constexpr int kMaxPeaks = 16;
+    constexpr float kPeakThreshold = 1e-4f;
+
+    struct Frame {
+        explicit Frame(int fftSize)
+            : input(fftSize), windowed(fftSize), magnitudes(fftSize / 2), power(fftSize / 2) {
+            spectrum = fftwf_alloc_complex(fftSize / 2 + 1);
+            plan = fftwf_plan_dft_r2c_1d(fftSize, windowed.data(), spectrum, FFTW_MEASURE);
+
+            std::mt19937 rng(1);
+            std::normal_distribution<float> noise(0.0f, 0.1f);
+            for (float& x : input) x = noise(rng);
+
+            // Kernel-only timings reuse this spectrum
+            std::copy(input.begin(), input.end(), windowed.begin());
+            fftwf_execute(plan);
+        }
+
+        ~Frame() {
+            fftwf_destroy_plan(plan);
+            fftwf_free(spectrum);
+        }
+
+        std::vector<float> input;
+        std::vector<float> windowed;
+        std::vector<float> magnitudes;
+        std::vector<float> power;
+        fftwf_complex* spectrum;
+        fftwf_plan plan;
+    };
+
+    template <typename Body>
+    double microsecondsPerCall(Body& body) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kCalls; ++i) body();
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / kCalls;
+    }
+
+    struct Timing {
+        double generic;  // Median microseconds per call
+        double fixed;
+    };
+
+    // Both paths of one stage, interleaved run by run
+    template <typename Stage>
+    Timing measure(const FrameKernels& generic, const FrameKernels& fixed, Stage stage) {
+        auto genericBody = [&] { stage(generic); };
+        auto fixedBody = [&] { stage(fixed); };
+        std::vector<double> genericTimes, fixedTimes;
+        for (int sample = 0; sample < kSamples; ++sample) {
+            genericTimes.push_back(microsecondsPerCall(genericBody));
+            fixedTimes.push_back(microsecondsPerCall(fixedBody));
+        }
+        std::nth_element(genericTimes.begin(), genericTimes.begin() + kSamples / 2, genericTimes.end());
+        std::nth_element(fixedTimes.begin(), fixedTimes.begin() + kSamples / 2, fixedTimes.end());
+        return {genericTimes[kSamples / 2], fixedTimes[kSamples / 2]};
+    }
+
+    void print(const char* name, Timing t) {
+        std::printf("   %-16s %8.2f -> %8.2f us (%.2fx)\n", name, t.generic, t.fixed, t.generic / t.fixed);
+    }
+
+    // Largest relative difference of the band powers of both paths
+    float compare(const FrameKernels& a, const FrameKernels& b, Frame& frame, int numBands) {
+        std::vector<float> bandsA(numBands), bandsB(numBands);
+        a.applyWindow(frame.input.data(), frame.windowed.data());
+        fftwf_execute(frame.plan);
+        a.computeSpectrum(frame.spectrum, frame.magnitudes.data(), frame.power.data(), nullptr);
+        a.applyPower(frame.power.data(), bandsA.data());
+
+        b.applyWindow(frame.input.data(), frame.windowed.data());
+        fftwf_execute(frame.plan);
+        b.computeSpectrum(frame.spectrum, frame.magnitudes.data(), frame.power.data(), nullptr);
+        b.applyPower(frame.power.data(), bandsB.data());
+
+        float worst = 0.0f;
+        for (int band = 0; band < numBands; ++band) {
+            float scale = std::max(std::fabs(bandsA[band]), 1e-20f);
+            worst = std::max(worst, std::fabs(bandsA[band] - bandsB[band]) / scale);
+        }
+        return worst;
+    }
+
+    template <int FftSize, int Bands>
+    void run() {
+        SpectrumConfig config;
+        config.fftSize = FftSize;
+        config.bands = Bands;
+        config.sampleRate = kSampleRate;
+
+        auto window = WindowFunction::get(config, FftSize);
+        auto layout = BandLayout::get(config, 0.0f, static_cast<float>(kSampleRate) / FftSize, FftSize / 2);
+
+        GenericFrameKernels generic(window, layout);
+        FixedFrameKernels<FftSize, Bands> fixed(window, *layout);
+
+        Frame frame(FftSize);
+        std::vector<float> bands(Bands);
+        PeakFinder finder(kMaxPeaks, kPeakThreshold);
+
+        auto spectrumPass = [&](const FrameKernels& kernels) {
+            finder.begin();
+            kernels.computeSpectrum(frame.spectrum, frame.magnitudes.data(), frame.power.data(), &finder);
+            finder.finish(frame.magnitudes.data(), 0.0f, 1.0f);
+        };
+        auto bandSums = [&](const FrameKernels& kernels) {
+            kernels.applyPower(frame.power.data(), bands.data());
+            kernels.applyMagnitude(frame.magnitudes.data(), bands.data());
+        };
+
+        std::printf("%6d / %-4d  max diff %.1e\n", FftSize, Bands, compare(generic, fixed, frame, Bands));
+        print("window", measure(generic, fixed, [&](const FrameKernels& k) {
+            k.applyWindow(frame.input.data(), frame.windowed.data());
+        }));
+        print("spectrum+peaks", measure(generic, fixed, spectrumPass));
+        print("band sums", measure(generic, fixed, bandSums));
+        print("frame with FFT", measure(generic, fixed, [&](const FrameKernels& k) {
+            k.applyWindow(frame.input.data(), frame.windowed.data());
+            fftwf_execute(frame.plan);
+            spectrumPass(k);
+            bandSums(k);
+        }));
+    }
+}
+
+int main() {
+    std::printf("FFT / bands  generic -> fixed, median of %d runs\n", kSamples);
+    run<4096, 64>();
+    run<8192, 128>();
+    run<16384, 256>();
+    return 0;
+}
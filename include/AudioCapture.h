@@ -12,7 +12,8 @@ class AudioCapture {
 public:
     using AudioCallback = std::function<void(const float* samples, size_t count)>;
 
-    AudioCapture(int sampleRate, int bufferSize);
+    // captureSink: record the monitor of the default sink instead of the default source
+    AudioCapture(int sampleRate, int bufferSize, bool captureSink = true);
     ~AudioCapture();
 
     bool initialize();
@@ -34,6 +35,7 @@ private:
 
     int sampleRate;
     int bufferSize;
+    bool captureSink;
     AudioCallback callback;
 
     pw_thread_loop* loop = nullptr;
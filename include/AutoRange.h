@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Config.h"
+#include "P2Quantile.h"
+
+// Display range that follows the band levels: low and high percentiles of
+// the band dB values are estimated with P-square over consecutive windows,
+// and the range glides towards the last complete window's estimate.
+class AutoRange {
+public:
+    explicit AutoRange(const SpectrumConfig& config);
+
+    // Band levels in dBFS of one frame, dt seconds after the previous one
+    void update(const float* levelsDb, int count, float dt);
+
+    float getMinDb() const { return minDb; }
+    float getMaxDb() const { return maxDb; }
+
+private:
+    P2Quantile low;
+    P2Quantile high;
+    float window;
+    float smoothingTime;
+    float elapsed = 0.0f;
+    bool haveTarget = false;
+
+    float targetMin;
+    float targetMax;
+    float minDb;
+    float maxDb;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Config.h"
+#include <vector>
+
+// Meter ballistics on band levels in dBFS, advanced by the real time between
+// frames so behavior does not depend on hop size, sample rate or refresh
+// rate. Working in dB rather than display levels keeps the state meaningful
+// when auto-range moves the display range.
+class Ballistics {
+public:
+    struct Params {
+        float attackTime = 0.0f;    // Rise time constant, seconds (0 = instant)
+        float releaseTime = 0.0f;   // Fall time constant, seconds (0 = instant)
+        float releaseRate = 0.0f;   // Linear fall in dB per second, overrides releaseTime
+        float peakHoldTime = 0.0f;  // Seconds a peak stays before falling
+        float peakFallRate = 0.0f;  // Peak fall in dB per second
+    };
+
+    // Params for the configured preset. hopSeconds converts the legacy
+    // per-frame smoothing factor into a time constant.
+    static Params fromConfig(const SpectrumConfig& config, float hopSeconds);
+
+    // Levels and peaks start at floorDb
+    Ballistics(int numBands, const Params& params, float floorDb);
+
+    void update(const float* input, float dt);
+
+    const std::vector<float>& getLevels() const { return levels; }
+    const std::vector<float>& getPeaks() const { return peaks; }
+
+private:
+    Params params;
+
+    std::vector<float> levels;
+    std::vector<float> peaks;
+    std::vector<float> peakAge;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Config.h"
+#include <vector>
+#include <memory>
+
+// Band edges on a frequency scale, compiled against one FFT bin grid into a
+// sparse weight matrix. Each row is a contiguous run of bins, stored CSR style
+// (row offsets into one weight array plus the first bin of the run).
+// The frequency weighting curve is folded into the bin weights.
+class BandLayout {
+public:
+    struct Span {
+        int first = 0;           // First bin of the row
+        int count = 0;           // Bins in the row
+        float centerBin = 0.0f;  // Fractional bin of the band center
+        bool narrow = false;     // Band is narrower than one bin
+    };
+
+    // Shared layout for these parameters, built on first use
+    static std::shared_ptr<const BandLayout> get(const SpectrumConfig& config, float binStartFreq,
+                                                 float binWidth, int numBins);
+
+    int getNumBands() const { return static_cast<int>(centers.size()); }
+    const std::vector<float>& getLow() const { return low; }
+    const std::vector<float>& getHigh() const { return high; }
+    const std::vector<float>& getCenters() const { return centers; }
+    const std::vector<Span>& getSpans() const { return spans; }
+
+    // Row weights with the frequency weighting folded in, spans[band].count values
+    const float* getPowerWeights(int band) const { return powerWeights.data() + rowOffsets[band]; }
+    const float* getMagnitudeWeights(int band) const { return magnitudeWeights.data() + rowOffsets[band]; }
+
+    // Sum of the band shape over one row, without frequency weighting
+    float getRowWeight(int band) const { return rowWeights[band]; }
+
+    // Frequency weighting gain at the band center, for single-value readouts
+    float getCenterGain(int band) const { return centerGains[band]; }
+
+    // out[band] = sum of shape * gain^2 * power[bin] over the row
+    void applyPower(const float* power, float* out) const;
+
+    // out[band] = sum of shape * gain * magnitude[bin] over the row
+    void applyMagnitude(const float* magnitudes, float* out) const;
+
+    BandLayout(const SpectrumConfig& config, float binStartFreq, float binWidth, int numBins);
+
+private:
+    void buildBands(const SpectrumConfig& config);
+    void buildRows(BandShape shape, float binStartFreq, float binWidth, int numBins);
+    void applyWeighting(FrequencyWeighting weighting, float binStartFreq, float binWidth);
+
+    std::vector<float> low;
+    std::vector<float> high;
+    std::vector<float> centers;
+
+    std::vector<Span> spans;
+    std::vector<int> rowOffsets;
+    std::vector<float> weights;           // Band shape
+    std::vector<float> powerWeights;      // Shape * weighting^2
+    std::vector<float> magnitudeWeights;  // Shape * weighting
+    std::vector<float> rowWeights;
+    std::vector<float> centerGains;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <fftw3.h>
+#include <vector>
+#include <cstdint>
+
+// Onset detection and tempo estimation from the magnitude spectra:
+// half-wave rectified log spectral flux against an adaptive threshold
+// (decided on the frame itself, so latency is one hop), and tempo from the
+// autocorrelation of the flux envelope, computed with an FFT every half second.
+class BeatTracker {
+public:
+    // framePeriod: seconds between frames; sensitivity: threshold above the local mean
+    BeatTracker(int numBins, float framePeriod, float sensitivity);
+    ~BeatTracker();
+
+    BeatTracker(const BeatTracker&) = delete;
+    BeatTracker& operator=(const BeatTracker&) = delete;
+
+    // Returns true if this frame is an onset
+    bool update(const float* magnitudes, double time);
+
+    uint64_t getOnsetCount() const { return onsetCount; }
+    double getOnsetTime() const { return onsetTime; }
+    float getOnsetStrength() const { return onsetStrength; }
+
+    float getTempo() const { return tempo; }  // BPM, 0 until estimated
+    double getTempoTime() const { return tempoTime; }
+
+private:
+    void estimateTempo(double time);
+
+    int numBins;
+    float framePeriod;
+    float sensitivity;
+
+    std::vector<float> previous;  // Log-compressed magnitudes of the previous frame
+
+    // Flux history for the adaptive threshold
+    std::vector<float> recent;
+    size_t recentPos = 0;
+    bool wasAbove = false;
+
+    // Onset envelope ring for the tempo estimate
+    std::vector<float> envelope;
+    size_t envelopePos = 0;
+    size_t envelopeFilled = 0;
+    int framesSinceTempo = 0;
+
+    int acfSize;
+    float* acfBuffer;
+    fftwf_complex* acfSpectrum;
+    fftwf_plan forwardPlan;
+    fftwf_plan inversePlan;
+
+    uint64_t onsetCount = 0;
+    double onsetTime = 0.0;
+    float onsetStrength = 0.0f;
+    float tempo = 0.0f;
+    double tempoTime = 0.0;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <fftw3.h>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+// Chirp-Z transform (Bluestein): evaluates the windowed DTFT of a real frame
+// of frameSize samples at numPoints frequencies startFreq + k * freqStep,
+// using one FFT convolution of length >= frameSize + numPoints - 1.
+class ChirpZ {
+public:
+    ChirpZ(int frameSize, int sampleRate, float startFreq, float freqStep, int numPoints);
+    ~ChirpZ();
+
+    ChirpZ(const ChirpZ&) = delete;
+    ChirpZ& operator=(const ChirpZ&) = delete;
+
+    // Unscaled DTFT magnitudes of an already windowed frame
+    void process(const float* frame, float* magnitudes);
+
+    int getNumPoints() const { return numPoints; }
+    float getStartFreq() const { return startFreq; }
+    float getFreqStep() const { return freqStep; }
+
+    // Largest grid one convolution length covers for this frame size
+    static int maxPointsFor(int frameSize);
+
+private:
+    struct Tables;
+    static std::shared_ptr<const Tables> getTables(int frameSize, int sampleRate,
+                                                   float startFreq, float freqStep, int numPoints);
+
+    int frameSize;
+    int numPoints;
+    float startFreq;
+    float freqStep;
+
+    std::shared_ptr<const Tables> tables;
+    fftwf_complex* work;
+};
+
+// Evaluates the spectrum at an arbitrary sorted list of frequencies by
+// splitting it into as few uniform chirp-z grids as the convolution length
+// allows, each sampled finely enough to interpolate the window main lobe.
+class ChirpZBands {
+public:
+    // scale converts DTFT magnitudes to output units (window amplitude scale)
+    ChirpZBands(int frameSize, int sampleRate, const std::vector<float>& frequencies, float scale);
+
+    void process(const float* frame);
+
+    const std::vector<float>& getMagnitudes() const { return magnitudes; }
+
+private:
+    struct Segment {
+        std::unique_ptr<ChirpZ> transform;
+        size_t firstFreq;
+        size_t numFreqs;
+    };
+
+    std::vector<float> frequencies;
+    float scale;
+    std::vector<Segment> segments;
+    std::vector<float> grid;
+    std::vector<float> magnitudes;
+};
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <array>
+#include <vector>
 #include <cstdint>
 
 struct WindowConfig {
@@ -11,6 +12,74 @@ struct WindowConfig {
     bool vsync = true;
 };
 
+// How FFT bins inside a band are combined into one level
+enum class BandAggregation {
+    Mean,         // Mean magnitude
+    Power,        // Power sum, reads tones at their level in wide bands
+    Max,          // Strongest bin
+    Interpolate,  // Value at the center for bands narrower than a bin, power sum otherwise
+    Reassigned,   // Power sum after moving each bin's energy to its reassigned frequency and time
+};
+
+// Frequency scale the band edges are spaced on
+enum class BandScale {
+    Log,
+    Linear,
+    Mel,
+    Bark,
+    Erb,
+    ThirdOctave,  // IEC 61260 base-2 third octaves, band count follows the range
+    Custom,       // Edges from band_edges
+};
+
+// Weight of each FFT bin within a band
+enum class BandShape {
+    Rectangular,  // Bins between the band edges, equal weight
+    Triangular,   // Overlapping triangles between neighbouring centers
+};
+
+// Frequency weighting applied to the band levels
+enum class FrequencyWeighting {
+    Z,       // Flat
+    A,
+    B,
+    C,
+    Itu468,  // ITU-R BS.468 noise weighting
+};
+
+// Level and peak meter ballistics
+enum class BallisticsPreset {
+    Smooth,  // Exponential, time constant from 'smoothing' at the configured hop
+    Vu,      // IEC 60268-17 VU
+    PpmDin,  // IEC 60268-10 Type I
+    PpmBbc,  // IEC 60268-10 Type IIa
+    Custom,  // attack_time / release_time / release_rate
+};
+
+// Analysis window
+enum class WindowType {
+    Hann,
+    BlackmanHarris,  // 4-term, -92 dB sidelobes
+    Kaiser,          // Shape set by kaiser_beta
+    FlatTop,         // Accurate tone amplitude
+    Gaussian,        // Width set by gaussian_sigma
+};
+
+// Long-term power spectrum averaging
+enum class AveragingMode {
+    Off,
+    Linear,       // Last average_frames frames
+    Exponential,  // Time constant average_time
+    Infinite,     // Running mean since the last reset
+};
+
+// What to do with band levels near the tracked noise floor
+enum class NoiseFloorMode {
+    Off,       // Fixed noise_threshold gate
+    Gate,      // Zero bands less than noise_floor_margin above the floor
+    Subtract,  // Spectral subtraction of the floor power
+};
+
 struct SpectrumConfig {
     int bands = 64;
     float minFreq = 20.0f;
@@ -20,10 +89,64 @@ struct SpectrumConfig {
     float smoothing = 0.7f;
     bool peakHoldEnabled = true;
     float peakFallTime = 1.5f;  // seconds
+    float peakHoldTime = 0.0f;  // seconds before a peak starts to fall
+    BallisticsPreset ballistics = BallisticsPreset::Smooth;
+    float attackTime = 0.01f;   // seconds, custom ballistics
+    float releaseTime = 0.3f;   // seconds, custom ballistics
+    float releaseRate = 0.0f;   // dB/s linear fall, custom ballistics (0 = use release_time)
+    WindowType window = WindowType::Hann;
+    float kaiserBeta = 9.0f;
+    float gaussianSigma = 0.4f; // Standard deviation relative to half the window
+    AveragingMode averaging = AveragingMode::Off;
+    int averageFrames = 64;
+    float averageTime = 10.0f;  // seconds, exponential averaging
+    bool traces = false;        // Max-hold, min-hold and reference traces
     float minDb = -80.0f;
     float maxDb = 0.0f;
     float noiseThreshold = 0.05f;
-    bool freqWeighting = true;
+    NoiseFloorMode noiseFloor = NoiseFloorMode::Off;
+    float noiseFloorWindow = 1.5f;  // seconds of minimum search
+    float noiseFloorMargin = 6.0f;  // dB above the floor a band needs to show
+    float noiseFloorMax = -50.0f;   // dBFS, steady content above this is never taken as noise
+    bool loudness = false;          // EBU R128 loudness meter on the stereo input
+    bool truePeak = false;          // 4x oversampled true-peak meter on the stereo input
+    float truePeakOver = -1.0f;     // dBTP, peaks above count as overs
+    bool stereo = false;            // Correlation, balance and mid/side bands
+    bool transfer = false;          // H1 transfer function and coherence between the channels
+    int transferReference = 0;      // Reference channel, 0 = left, 1 = right
+    float transferAverageTime = 2.0f;  // seconds
+    bool transferAutoDelay = true;  // GCC-PHAT delay compensation
+    int peakCount = 0;              // Strongest spectral peaks listed per frame, 0 = off
+    float peakThreshold = -80.0f;   // dBFS, quieter peaks are not listed
+    bool feedback = false;          // Feedback (howl) detection on the peak list
+    int feedbackHops = 8;           // Frames a peak must persist
+    float feedbackRatio = 20.0f;    // dB above the neighbouring bins
+    float feedbackGrowth = -0.5f;   // dB/s, minimum level growth
+    bool beats = false;             // Onset and tempo detection
+    float onsetSensitivity = 1.5f;  // Threshold in mean deviations above the local mean
+    bool pitch = false;             // YIN pitch estimate (full-band FFT only)
+    float pitchMinFreq = 40.0f;     // Hz, limited to sample_rate / (fft_size / 2)
+    float pitchMaxFreq = 2000.0f;   // Hz
+    bool chroma = false;            // 12-bin chromagram
+    bool features = false;          // Centroid, spread, flatness, rolloff, flux, crest
+    std::string featuresFile;       // CSV, one row per frame; empty = no export
+    bool harmonics = false;         // Hum / THD+N measurement (full-band FFT only)
+    float harmonicMinFreq = 40.0f;  // Fundamental search range, Hz
+    float harmonicMaxFreq = 2000.0f;
+    int harmonicCount = 10;         // Including the fundamental
+    bool autoRange = false;         // Follow the band levels instead of min_db/max_db
+    float autoRangeLow = 5.0f;      // Percentile at the bottom of the display
+    float autoRangeHigh = 99.5f;    // Percentile at the top of the display
+    float autoRangeWindow = 5.0f;   // seconds per quantile window
+    float autoRangeTime = 2.0f;     // seconds, range glide time constant
+    FrequencyWeighting freqWeighting = FrequencyWeighting::A;
+    bool zoomFFT = false;       // Zoom FFT for narrow min/max ranges
+    int zoomFFTSize = 1024;     // Complex FFT size after decimation
+    bool cztBands = false;      // Evaluate bands at their centers with a chirp-z transform
+    BandAggregation bandAggregation = BandAggregation::Mean;
+    BandScale bandScale = BandScale::Log;
+    BandShape bandShape = BandShape::Rectangular;
+    std::vector<float> bandEdges;  // Hz, for BandScale::Custom
 };
 
 struct VisualizationConfig {
@@ -31,6 +154,14 @@ struct VisualizationConfig {
     std::array<uint8_t, 3> barColorMid = {255, 255, 0};
     std::array<uint8_t, 3> barColorHigh = {255, 0, 0};
     std::array<uint8_t, 3> peakColor = {255, 255, 255};
+    std::array<uint8_t, 3> averageColor = {0, 200, 255};
+    std::array<uint8_t, 3> maxHoldColor = {255, 80, 80};
+    std::array<uint8_t, 3> minHoldColor = {80, 120, 255};
+    std::array<uint8_t, 3> referenceColor = {255, 220, 0};
+    std::array<uint8_t, 3> sideColor = {200, 80, 255};
+    std::array<uint8_t, 3> transferColor = {255, 160, 0};
+    std::array<uint8_t, 3> coherenceColor = {120, 120, 120};
+    std::array<uint8_t, 3> feedbackColor = {255, 0, 0};
     int barGap = 2;
     bool barGradient = true;
 };
@@ -38,6 +169,33 @@ struct VisualizationConfig {
 struct AudioConfig {
     int targetLatency = 20;
     int bufferSize = 1024;
+    bool captureSink = true;  // Monitor of the default sink; false = default source (microphone)
+};
+
+// Exponential sine sweep impulse response measurement (sweep subcommands)
+struct SweepConfig {
+    int sampleRate = 48000;
+    float startFreq = 20.0f;    // Hz
+    float endFreq = 20000.0f;   // Hz
+    float duration = 10.0f;     // seconds of sweep
+    float level = -6.0f;        // dBFS
+    float fade = 0.05f;         // seconds, half-Hann fade in and out
+    float silence = 3.0f;       // seconds after the sweep for the decay
+    float irLength = 1.0f;      // seconds of impulse response kept
+    int harmonics = 5;          // Highest distortion order extracted
+    int channel = 0;            // Recording channel analyzed
+};
+
+// Waterfall and reverberation time of an impulse response (sweep and ir subcommands)
+struct DecayConfig {
+    float csdGate = 0.3f;       // seconds from the direct sound to the end of every slice
+    float csdStep = 0.01f;      // seconds between slices
+    int csdSlices = 25;
+    float csdRise = 0.0005f;    // seconds, half-Hann rise at each slice start
+    int csdPoints = 240;        // Log-spaced frequencies
+    float minFreq = 20.0f;
+    float maxFreq = 20000.0f;
+    int threads = 0;            // 0 = one per core
 };
 
 class Config {
@@ -49,10 +207,14 @@ public:
     const SpectrumConfig& getSpectrum() const { return spectrum; }
     const VisualizationConfig& getVisualization() const { return visualization; }
     const AudioConfig& getAudio() const { return audio; }
+    const SweepConfig& getSweep() const { return sweep; }
+    const DecayConfig& getDecay() const { return decay; }
 
 private:
     WindowConfig window;
     SpectrumConfig spectrum;
     VisualizationConfig visualization;
     AudioConfig audio;
+    SweepConfig sweep;
+    DecayConfig decay;
 };
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Config.h"
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// Sample index of the direct sound: the largest absolute value
+size_t findDirectSound(const std::vector<float>& impulse);
+
+// Cumulative spectral decay (waterfall) of an impulse response. Each slice
+// starts a step later than the previous one and ends at the same gate, with
+// a short rise and a fixed fall window; all slices are transformed by
+// batched FFTW plans, split across threads. Levels are smoothed to
+// 1/24 octave on a log frequency grid.
+class CumulativeSpectralDecay {
+public:
+    CumulativeSpectralDecay(const DecayConfig& config, int sampleRate);
+
+    // start: direct sound sample, the first slice begins there
+    void process(const std::vector<float>& impulse, size_t start);
+
+    const std::vector<float>& getFrequencies() const { return frequencies; }
+    const std::vector<float>& getSliceTimes() const { return sliceTimes; }  // Seconds after start
+    const std::vector<std::vector<float>>& getSlices() const { return slices; }  // dB re first slice peak
+
+    // One row per slice: time, then the level at each frequency
+    bool write(const std::string& path) const;
+
+private:
+    struct Span {
+        int first;
+        int count;
+    };
+
+    DecayConfig config;
+    int sampleRate;
+    int fftSize;
+    int gateLength;
+    int stepLength;
+    int riseLength;
+    int fallLength;
+
+    std::vector<float> frequencies;
+    std::vector<Span> spans;  // Bins averaged for each frequency
+    std::vector<float> sliceTimes;
+    std::vector<std::vector<float>> slices;
+};
+
+// Reverberation time per octave band (63 Hz - 8 kHz) from Schroeder
+// backward integration, after subtracting the noise floor and truncating
+// where the decay meets it. EDT from 0 to -10 dB, T20 from -5 to -25 dB and
+// T30 from -5 to -35 dB, each extrapolated to 60 dB. Octave bands are
+// zero-phase power-complementary filters applied in one spectrum and
+// brought back with one batched inverse FFT.
+class ReverberationTime {
+public:
+    struct Band {
+        float center;  // Hz
+        float edt;     // Seconds, 0 where the decay is too short
+        float t20;
+        float t30;
+    };
+
+    explicit ReverberationTime(int sampleRate);
+
+    void process(const std::vector<float>& impulse, size_t start);
+
+    const std::vector<Band>& getBands() const { return bands; }
+
+    bool write(const std::string& path) const;
+
+private:
+    int sampleRate;
+    std::vector<Band> bands;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+
+// Small inner-loop kernels shared by the analysis stages.
+// Reductions keep kLanes independent accumulators so the compiler can keep
+// them in one vector register (-O3 -march=native) without -ffast-math.
+namespace dsp {
+
+constexpr size_t kLanes = 8;
+
+inline float horizontalSum(const float (&acc)[kLanes]) {
+    float sum = 0.0f;
+    for (size_t l = 0; l < kLanes; ++l) sum += acc[l];
+    return sum;
+}
+
+// Sum of a[i] * b[i]
+inline float dot(const float* a, const float* b, size_t n) {
+    float acc[kLanes] = {};
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (size_t l = 0; l < kLanes; ++l) acc[l] += a[i + l] * b[i + l];
+    }
+    float sum = horizontalSum(acc);
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+inline float sum(const float* x, size_t n) {
+    float acc[kLanes] = {};
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (size_t l = 0; l < kLanes; ++l) acc[l] += x[i + l];
+    }
+    float total = horizontalSum(acc);
+    for (; i < n; ++i) total += x[i];
+    return total;
+}
+
+inline float sumSquares(const float* x, size_t n) {
+    return dot(x, x, n);
+}
+
+// Maximum of non-negative values (magnitudes, powers)
+inline float maxValue(const float* x, size_t n) {
+    float acc[kLanes] = {};
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (size_t l = 0; l < kLanes; ++l) acc[l] = acc[l] > x[i + l] ? acc[l] : x[i + l];
+    }
+    float result = 0.0f;
+    for (size_t l = 0; l < kLanes; ++l) result = result > acc[l] ? result : acc[l];
+    for (; i < n; ++i) result = result > x[i] ? result : x[i];
+    return result;
+}
+
+// acc[i] = max(acc[i], x[i]) and acc[i] = min(acc[i], x[i]), for hold traces.
+// Written as selects so they vectorize to packed max/min.
+inline void maxInto(float* acc, const float* x, size_t n) {
+    for (size_t i = 0; i < n; ++i) acc[i] = acc[i] > x[i] ? acc[i] : x[i];
+}
+
+inline void minInto(float* acc, const float* x, size_t n) {
+    for (size_t i = 0; i < n; ++i) acc[i] = acc[i] < x[i] ? acc[i] : x[i];
+}
+
+// Two dot products sharing the same coefficients (complex FIR with real taps)
+inline void dot2(const float* h, const float* re, const float* im, size_t n,
+                 float& outRe, float& outIm) {
+    float accRe[kLanes] = {};
+    float accIm[kLanes] = {};
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (size_t l = 0; l < kLanes; ++l) {
+            accRe[l] += h[i + l] * re[i + l];
+            accIm[l] += h[i + l] * im[i + l];
+        }
+    }
+    outRe = horizontalSum(accRe);
+    outIm = horizontalSum(accIm);
+    for (; i < n; ++i) {
+        outRe += h[i] * re[i];
+        outIm += h[i] * im[i];
+    }
+}
+
+} // namespace dsp
@@ -1,50 +1,163 @@
 #pragma once
 
+#include "Config.h"
+#include "WindowFunction.h"
+#include "ZoomFFT.h"
+#include "ChirpZ.h"
+#include "BandLayout.h"
+#include "FrameKernels.h"
+#include "Ballistics.h"
+#include "SpectrumAverager.h"
+#include "TraceSet.h"
+#include "NoiseFloor.h"
+#include "AutoRange.h"
+#include "LoudnessMeter.h"
+#include "TruePeakMeter.h"
+#include "StereoAnalyzer.h"
+#include "TransferAnalyzer.h"
+#include "PeakFinder.h"
+#include "FeedbackDetector.h"
+#include "BeatTracker.h"
+#include "PitchAnalysis.h"
+#include "SpectralFeatures.h"
+#include "HarmonicAnalyzer.h"
+#include "ReassignedSpectrum.h"
+#include "SpectrumSnapshot.h"
 #include <fftw3.h>
 #include <vector>
 #include <mutex>
+#include <memory>
 
 class FFTAnalyzer {
 public:
-    FFTAnalyzer(int fftSize, int sampleRate, int numBands, float minFreq, float maxFreq,
-                float minDb = -80.0f, float maxDb = 0.0f, float noiseThreshold = 0.05f,
-                bool freqWeighting = true, float smoothing = 0.3f);
+    explicit FFTAnalyzer(const SpectrumConfig& config);
     ~FFTAnalyzer();
 
     void process(const float* samples, size_t count);
 
-    const std::vector<float>& getBands() const { return bands; }
-    const std::vector<float>& getPeaks() const { return peaks; }
+    // Copy of the latest published results, reuses out's storage
+    void getSnapshot(SpectrumSnapshot& out) const;
 
-    void updatePeaks(float decayAmount);
+    // Next feedback event, lock-free; call from one consumer thread only
+    bool popFeedbackEvent(FeedbackEvent& event);
+
+    // Next spectral feature frame, lock-free; call from one consumer thread only
+    bool popFeatureFrame(SpectralFeatureFrame& frame);
+
+    // Restarts the transfer function averages and delay search
+    void resetTransfer();
+
+    // Long-term average controls, no-ops when averaging is off
+    void resetAverage();
+    void setAverageFrozen(bool frozen);
+    bool isAverageFrozen() const;
+
+    // Restarts integrated loudness, range, max true peak and overs
+    // (whichever meters are on)
+    void resetLoudness();
+
+    // Measurement traces, no-ops when traces are off
+    void resetHolds();
+    void captureReference();
+    void clearReference();
 
 private:
     void performFFT();
+    void aggregateBands(const float* mag, const float* pow, float* out) const;
     void calculateBands();
-    int freqToFFTBin(float freq) const;
-    float getFrequencyWeight(float freq) const;
+    void calculateAverage(float dt);
+    static float toDb(float level);
+    float dbToDisplay(float db) const;
+    void dbToDisplay(const std::vector<float>& db, std::vector<float>& out) const;
+    void applyNoiseFloor(float dt);
+    void publish();
 
     int fftSize;
     int sampleRate;
-    int numBands;
+    int numBands = 0;
     float minFreq;
     float maxFreq;
-    float minDb;
+    float minDb;  // Display range, moves with auto-range
     float maxDb;
     float noiseThreshold;
-    bool freqWeighting;
-    float smoothing;
+    BandAggregation aggregation;
+    NoiseFloorMode noiseFloorMode;
+    float noiseFloorMargin;  // Power ratio
 
+    std::vector<float> monoBuffer;
     std::vector<float> inputBuffer;
-    std::vector<float> windowFunction;
+    std::vector<float> windowedBuffer;
+    std::vector<float> leftBuffer;   // Stereo stage frames, same framing as inputBuffer
+    std::vector<float> rightBuffer;
+    std::shared_ptr<const WindowFunction> window;
+    float enbw = 1.0f;  // Of the window feeding the spectrum, in bins
     size_t bufferPos = 0;
 
+    // Audio time, drives the ballistics
+    uint64_t samplesIngested = 0;
+    double frameTime = 0.0;
+    double lastFrameTime = 0.0;
+
     fftwf_complex* fftOutput;
-    fftwf_plan fftPlan;
+    fftwf_plan fftPlan = nullptr;
+
+    // Narrow-band path, replaces the full-band FFT when enabled
+    std::unique_ptr<ZoomFFT> zoomFFT;
+
+    // Band values sampled at the band centers instead of averaged FFT bins
+    std::unique_ptr<ChirpZBands> chirpZBands;
+
+    // Band power from reassigned bin energy, full-band FFT only
+    std::unique_ptr<ReassignedSpectrum> reassigned;
+
+    // Linear magnitude and power spectrum of the latest frame, index 0 is at binStartFreq
+    std::vector<float> magnitudes;
+    std::vector<float> power;
+    float binStartFreq = 0.0f;
+    float binWidth = 0.0f;
+
+    std::shared_ptr<const BandLayout> layout;
+
+    // Windowing, spectrum and band sums, specialized for the deployed sizes
+    std::unique_ptr<FrameKernels> kernels;
+
+    // Fed from the magnitude loop, refined after each frame
+    std::unique_ptr<PeakFinder> peakFinder;
+    bool publishPeaks = false;
+    std::unique_ptr<FeedbackDetector> feedback;
+    std::unique_ptr<BeatTracker> beats;
+    std::unique_ptr<PitchDetector> pitch;
+    std::unique_ptr<Chromagram> chroma;
+    std::unique_ptr<SpectralFeatures> features;
+    std::unique_ptr<HarmonicAnalyzer> harmonics;
+    bool harmonicsShareSpectrum = false;  // Display window is already flat-top
+
+    std::vector<float> bandLevels;  // Weighted linear level per band
+    std::vector<float> bandDb;      // Gated, held at the display bottom; ballistics input
+    std::unique_ptr<Ballistics> ballistics;
+
+    std::unique_ptr<NoiseFloor> noiseFloor;
+
+    std::unique_ptr<AutoRange> autoRange;
+    std::vector<float> bandPower;
+
+    std::unique_ptr<SpectrumAverager> averager;
+    std::vector<float> averageMagnitudes;
+    std::vector<float> averageLevels;  // dBFS
+
+    std::unique_ptr<TraceSet> traces;
+
+    // Fed the stereo input before the mono downmix
+    std::unique_ptr<LoudnessMeter> loudness;
+    std::unique_ptr<TruePeakMeter> truePeak;
+    std::unique_ptr<TransferAnalyzer> transfer;
+
+    // Replaces the mono FFT: its mid spectrum is the downmix's spectrum
+    std::unique_ptr<StereoAnalyzer> stereo;
 
-    std::vector<float> bands;
-    std::vector<float> peaks;
-    std::vector<float> smoothedBands;
+    // Written by the analysis thread at the end of each frame
+    SpectrumSnapshot snapshot;
+    uint64_t frameCount = 0;
 
     mutable std::mutex mutex;
 };
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "PeakFinder.h"
+#include "BandLayout.h"
+#include "SpscQueue.h"
+#include <array>
+#include <memory>
+#include <cstdint>
+
+struct FeedbackEvent {
+    float frequency = 0.0f;  // Hz
+    float levelDb = 0.0f;    // dBFS
+    float ratioDb = 0.0f;    // Peak over its neighbourhood
+    float growth = 0.0f;     // dB per second
+    int band = -1;           // Display band containing the frequency
+    double timestamp = 0.0;  // Audio time, seconds
+};
+
+// Feedback (howl) detector on the per-frame peak list: a peak is tracked
+// across hops and reported once it has stayed narrow and stable in
+// frequency for enough hops, stands far enough above its neighbourhood and
+// is not decaying. Work per frame is bounded by the peak count and the
+// fixed number of tracks. Events go to a lock-free queue for the render
+// thread.
+class FeedbackDetector {
+public:
+    struct Params {
+        int hops = 8;               // Frames a peak must persist
+        float minRatioDb = 20.0f;   // Peak to neighbourhood ratio
+        float minGrowth = -0.5f;    // dB per second, slightly negative so a steady howl passes
+    };
+
+    FeedbackDetector(const Params& params, std::shared_ptr<const BandLayout> layout);
+
+    // Peaks of one frame, mag is the spectrum they were found in
+    void update(const std::vector<PeakFinder::Peak>& peaks, const float* mag, int numBins,
+                float binStartFreq, float binWidth, double time, float dt);
+
+    // Called from the consumer thread
+    bool popEvent(FeedbackEvent& event) { return events.pop(event); }
+
+private:
+    static constexpr int kMaxTracks = 16;
+    static constexpr int kMaxMisses = 2;
+
+    struct Track {
+        bool active = false;
+        bool reported = false;
+        float frequency = 0.0f;
+        float levelDb = 0.0f;
+        float growth = 0.0f;
+        float drift = 0.0f;  // Smoothed frequency change per hop, bins
+        int hits = 0;
+        int misses = 0;
+    };
+
+    float neighbourhoodRatioDb(const float* mag, int numBins, int bin, float peak) const;
+    int bandOf(float frequency) const;
+
+    Params params;
+    std::shared_ptr<const BandLayout> layout;
+    std::array<Track, kMaxTracks> tracks;
+    std::array<bool, kMaxTracks> matched{};
+    SpscQueue<FeedbackEvent, 64> events;
+};
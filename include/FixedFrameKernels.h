@@ -0,0 +1,150 @@
+#pragma once
+
+#include "FrameKernels.h"
+#include "DspKernels.h"
+#include <array>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+
+// Frame kernels compiled for one FFT size and band count. Frame and bin
+// loops have compile-time trip counts with no remainder, and band rows are
+// padded with zero weights to whole lane blocks so every band sum is a run
+// of fixed-width vector blocks. Row lengths come from the runtime layout, so
+// only the lane loop, not the row, is unrolled. Cosine-sum windows are read
+// from tables built at compile time; Kaiser and Gaussian use the shared
+// runtime table.
+template <int FftSize, int Bands>
+class FixedFrameKernels final : public FrameKernels {
+public:
+    static constexpr int kBins = FftSize / 2;
+    static constexpr int kLanes = static_cast<int>(dsp::kLanes);
+    static constexpr int kChunk = FrameKernels::kSpectrumChunk;
+    static_assert(kBins % kLanes == 0, "FFT size must split into whole lane blocks");
+    static_assert(kBins % kChunk == 0, "FFT size must split into whole spectrum chunks");
+
+    // Layout must be on this FFT size's full-band grid
+    static bool matches(const WindowFunction& window, const BandLayout& layout, int numBins) {
+        return window.size() == FftSize && numBins == kBins && layout.getNumBands() == Bands;
+    }
+
+    FixedFrameKernels(std::shared_ptr<const WindowFunction> window, const BandLayout& layout)
+        : window(std::move(window)) {
+        amplitudeScale = this->window->getAmplitudeScale();
+        powerScale = this->window->getPowerScale();
+        windowData = tableFor(this->window->getType());
+        if (!windowData) windowData = this->window->data();
+
+        // Rows that would pad past the last bin start earlier, with leading zeros
+        const auto& spans = layout.getSpans();
+        for (int band = 0; band < Bands; ++band) {
+            const int count = spans[band].count;
+            const int blocks = (count + kLanes - 1) / kLanes;
+            const int first = count > 0 ? std::min(spans[band].first, kBins - blocks * kLanes) : 0;
+            const int lead = count > 0 ? spans[band].first - first : 0;
+            const int trail = blocks * kLanes - lead - count;
+            rows[band] = {first, blocks, static_cast<int>(powerWeights.size())};
+
+            const float* power = layout.getPowerWeights(band);
+            const float* magnitude = layout.getMagnitudeWeights(band);
+            powerWeights.insert(powerWeights.end(), lead, 0.0f);
+            powerWeights.insert(powerWeights.end(), power, power + count);
+            powerWeights.insert(powerWeights.end(), trail, 0.0f);
+            magnitudeWeights.insert(magnitudeWeights.end(), lead, 0.0f);
+            magnitudeWeights.insert(magnitudeWeights.end(), magnitude, magnitude + count);
+            magnitudeWeights.insert(magnitudeWeights.end(), trail, 0.0f);
+        }
+    }
+
+    void applyWindow(const float* input, float* out) const override {
+        const float* w = windowData;
+        for (int i = 0; i < FftSize; ++i) {
+            out[i] = input[i] * w[i];
+        }
+    }
+
+    void computeSpectrum(const fftwf_complex* spectrum, float* magnitudes, float* power,
+                         PeakFinder* finder) const override {
+        if (!finder) {
+            spectrumRun<kBins>(spectrum, magnitudes, power, 0);
+            return;
+        }
+
+        // A chunk of bins, then its peak offers (the previous bin has both
+        // neighbours once a bin is written), so the scan reads the chunk
+        // from L1 and the chunk loop itself vectorizes
+        for (int first = 0; first < kBins; first += kChunk) {
+            spectrumRun<kChunk>(spectrum, magnitudes, power, first);
+            finder->offerRange(magnitudes, std::max(first - 1, 1), first + kChunk - 1);
+        }
+    }
+
+    void applyPower(const float* power, float* out) const override {
+        sumRows(powerWeights.data(), power, out);
+    }
+
+    void applyMagnitude(const float* magnitudes, float* out) const override {
+        sumRows(magnitudeWeights.data(), magnitudes, out);
+    }
+
+    std::string getName() const override {
+        return "fixed " + std::to_string(FftSize) + "/" + std::to_string(Bands);
+    }
+
+private:
+    struct Row {
+        int first;   // First bin, lane block aligned to the row's weights
+        int blocks;  // kLanes bins each
+        int offset;  // Into the weight arrays
+    };
+
+    static constexpr std::array<float, FftSize> kHann = windows::cosineSumTable<FftSize>(windows::kHann);
+    static constexpr std::array<float, FftSize> kBlackmanHarris =
+        windows::cosineSumTable<FftSize>(windows::kBlackmanHarris);
+    static constexpr std::array<float, FftSize> kFlatTop = windows::cosineSumTable<FftSize>(windows::kFlatTop);
+
+    template <int Count>
+    void spectrumRun(const fftwf_complex* spectrum, float* magnitudes, float* power, int first) const {
+        for (int bin = first; bin < first + Count; ++bin) {
+            float real = spectrum[bin][0];
+            float imag = spectrum[bin][1];
+            float squared = real * real + imag * imag;
+            power[bin] = squared * powerScale;
+            magnitudes[bin] = std::sqrt(squared) * amplitudeScale;
+        }
+    }
+
+    static const float* tableFor(WindowType type) {
+        switch (type) {
+            case WindowType::Hann: return kHann.data();
+            case WindowType::BlackmanHarris: return kBlackmanHarris.data();
+            case WindowType::FlatTop: return kFlatTop.data();
+            default: return nullptr;
+        }
+    }
+
+    void sumRows(const float* weights, const float* x, float* out) const {
+        for (int band = 0; band < Bands; ++band) {
+            const Row& row = rows[band];
+            const float* w = weights + row.offset;
+            const float* v = x + row.first;
+            float acc[kLanes] = {};
+            for (int block = 0; block < row.blocks; ++block) {
+                for (int l = 0; l < kLanes; ++l) {
+                    acc[l] += w[block * kLanes + l] * v[block * kLanes + l];
+                }
+            }
+            out[band] = dsp::horizontalSum(acc);
+        }
+    }
+
+    std::shared_ptr<const WindowFunction> window;
+    const float* windowData;
+    float amplitudeScale;
+    float powerScale;
+
+    std::array<Row, Bands> rows;
+    std::vector<float> powerWeights;
+    std::vector<float> magnitudeWeights;
+};
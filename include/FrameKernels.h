@@ -0,0 +1,60 @@
+#pragma once
+
+#include "WindowFunction.h"
+#include "BandLayout.h"
+#include "PeakFinder.h"
+#include <fftw3.h>
+#include <memory>
+#include <string>
+
+// Per-frame inner loops of the analyzer: windowing, the magnitude / power
+// pass and the weighted band sums. create() returns a version compiled for
+// the FFT size and band count when one of the deployed pairs matches
+// (FixedFrameKernels.h) and the generic one otherwise.
+class FrameKernels {
+public:
+    virtual ~FrameKernels() = default;
+
+    // Bins per spectrum step when peaks are offered from the same pass
+    static constexpr int kSpectrumChunk = 64;
+
+    // out = input * window, fftSize samples
+    virtual void applyWindow(const float* input, float* out) const = 0;
+
+    // Amplitude-scaled magnitude and power of fftSize / 2 bins. Bins are
+    // offered to finder (may be null) from the same loop; begin() and
+    // finish() are the caller's.
+    virtual void computeSpectrum(const fftwf_complex* spectrum, float* magnitudes, float* power,
+                                 PeakFinder* finder) const = 0;
+
+    // Same results as BandLayout::applyPower / applyMagnitude
+    virtual void applyPower(const float* power, float* out) const = 0;
+    virtual void applyMagnitude(const float* magnitudes, float* out) const = 0;
+
+    virtual std::string getName() const = 0;
+
+    // numBins: size of the grid the layout was built on
+    static std::unique_ptr<FrameKernels> create(std::shared_ptr<const WindowFunction> window,
+                                                std::shared_ptr<const BandLayout> layout, int numBins);
+};
+
+// Any size and layout, sizes read at run time
+class GenericFrameKernels : public FrameKernels {
+public:
+    GenericFrameKernels(std::shared_ptr<const WindowFunction> window, std::shared_ptr<const BandLayout> layout);
+
+    void applyWindow(const float* input, float* out) const override;
+    void computeSpectrum(const fftwf_complex* spectrum, float* magnitudes, float* power,
+                         PeakFinder* finder) const override;
+    void applyPower(const float* power, float* out) const override;
+    void applyMagnitude(const float* magnitudes, float* out) const override;
+
+    std::string getName() const override { return "generic"; }
+
+private:
+    std::shared_ptr<const WindowFunction> window;
+    std::shared_ptr<const BandLayout> layout;
+    int fftSize;
+    float amplitudeScale;
+    float powerScale;
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "Config.h"
+
+// Linear amplitude gain of a standard weighting curve at freq Hz
+// (IEC 61672-1 A/B/C/Z, ITU-R BS.468-4). 0 dB at 1 kHz for A/B/C/Z,
+// +12.2 dB at 6.3 kHz for ITU-R 468.
+float frequencyWeightGain(FrequencyWeighting weighting, float freq);
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "WindowFunction.h"
+#include <fftw3.h>
+#include <vector>
+#include <memory>
+#include <limits>
+
+// Hum and distortion measurement: locks onto the strongest tone in a search
+// range (mains hum, a test tone), refines its frequency to a fraction of a
+// bin and sums each harmonic over its whole flat-top main lobe. THD is the
+// harmonic power over the fundamental, THD+N everything in the measurement
+// band except the fundamental over the total.
+class HarmonicAnalyzer {
+public:
+    // numHarmonics counts the fundamental
+    HarmonicAnalyzer(int frameSize, int sampleRate, float minFreq, float maxFreq, int numHarmonics);
+    ~HarmonicAnalyzer();
+
+    HarmonicAnalyzer(const HarmonicAnalyzer&) = delete;
+    HarmonicAnalyzer& operator=(const HarmonicAnalyzer&) = delete;
+
+    // Unwindowed time-domain frame; runs its own flat-top FFT
+    void process(const float* frame);
+
+    // Power spectrum of a frame already analyzed with a flat-top window
+    void analyze(const float* power);
+
+    float getFundamental() const { return fundamental; }      // Hz, 0 with no signal
+    float getFundamentalDb() const { return fundamentalDb; }  // dBFS
+    const std::vector<float>& getHarmonicsDb() const { return harmonicsDb; }  // dBc, 2nd harmonic first
+    float getThd() const { return thd; }    // Ratio
+    float getThdN() const { return thdN; }  // Ratio
+
+    // False while the harmonics are closer than a flat-top lobe; THD, THD+N
+    // and the harmonic levels are not measured then
+    bool isResolved() const { return resolved; }
+
+private:
+    struct Span {
+        int first;
+        int count;
+    };
+
+    void lockHarmonics(float fundamentalBins);
+    float spanPower(const float* power, const Span& span) const;
+
+    int frameSize;
+    int numBins;
+    float binWidth;
+    int numHarmonics;
+    int searchFirst;
+    int searchLast;
+    Span band;  // Measurement band for THD+N
+
+    // Bin sets of the harmonics, rebuilt only when the fundamental moves far
+    // enough to shift the highest harmonic by half a bin
+    float lockedBins = -1.0f;
+    bool resolved = true;
+    std::vector<Span> harmonicSpans;
+
+    std::shared_ptr<const WindowFunction> window;
+    float* timeBuffer;
+    fftwf_complex* spectrum;
+    fftwf_plan plan;
+    std::vector<float> power;
+
+    float fundamental = 0.0f;
+    float fundamentalDb = -std::numeric_limits<float>::infinity();
+    std::vector<float> harmonicsDb;
+    float thd = 0.0f;
+    float thdN = 0.0f;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+// ITU-R BS.1770-4 / EBU R128 loudness of an interleaved stereo stream:
+// K-weighting, momentary (400 ms) and short-term (3 s) loudness, gated
+// integrated loudness and loudness range (EBU Tech 3342).
+// Gating works on fixed 0.1 LU histograms, so memory does not grow with run time.
+class LoudnessMeter {
+public:
+    explicit LoudnessMeter(int sampleRate);
+
+    void process(const float* samples, size_t frames);
+    void reset();
+
+    // LUFS, or -inf until enough audio has been measured
+    float getMomentary() const { return momentary; }
+    float getShortTerm() const { return shortTerm; }
+    float getIntegrated() const { return integrated; }
+
+    // LU
+    float getRange() const { return range; }
+
+private:
+    struct Biquad {
+        double b0, b1, b2, a1, a2;
+    };
+
+    // Transposed direct form II state
+    struct FilterState {
+        double z1 = 0.0;
+        double z2 = 0.0;
+    };
+
+    static constexpr int kChannels = 2;
+    static constexpr int kShortTermBlocks = 30;  // 100 ms blocks
+    static constexpr int kMomentaryBlocks = 4;
+
+    void endBlock();
+    void updateIntegrated();
+    void updateRange();
+
+    Biquad shelf;
+    Biquad highPass;
+    FilterState state[kChannels][2];
+
+    int blockSize;  // Samples per 100 ms block
+    int blockPos = 0;
+    double blockSum = 0.0;
+
+    // Ring of mean square per 100 ms block, summed over channels
+    std::array<double, kShortTermBlocks> blocks{};
+    int blockIndex = 0;
+    int blocksFilled = 0;
+
+    std::vector<uint64_t> momentaryHistogram;
+    std::vector<uint64_t> shortTermHistogram;
+
+    float momentary;
+    float shortTerm;
+    float integrated;
+    float range;
+};
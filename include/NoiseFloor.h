@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+
+// Per-band noise floor by minimum statistics (after Martin, 2001): the floor is
+// the minimum of the smoothed band power over a sliding window, tracked as
+// the minima of a few sub-windows so each frame costs O(1) per band.
+class NoiseFloor {
+public:
+    // maxFloor caps the estimate (linear power): a steady tone is its own
+    // minimum and would otherwise be tracked as noise
+    NoiseFloor(int numBands, float windowSeconds, float maxFloor);
+
+    // Linear band power of one frame, dt seconds after the previous one
+    void update(const float* power, float dt);
+
+    // Estimated noise power per band, bias compensated
+    const std::vector<float>& getFloor() const { return floor; }
+
+private:
+    static constexpr int kSubWindows = 8;
+
+    int numBands;
+    float subWindowTime;
+    float maxFloor;
+    float subElapsed = 0.0f;
+    int subIndex = 0;
+    bool primed = false;
+
+    std::vector<float> smoothed;    // Power smoothed over ~100 ms
+    std::vector<float> currentMin;  // Minimum of the running sub-window
+    std::vector<float> subMins;     // kSubWindows rows of completed sub-window minima
+    std::vector<float> windowMin;   // Minimum over subMins
+    std::vector<float> floor;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+// Streaming quantile estimate with the P-square algorithm (Jain & Chlamtac,
+// 1985): five markers follow the minimum, the quantile, the two midpoints
+// and the maximum with piecewise-parabolic corrections. Constant memory,
+// no stored samples.
+class P2Quantile {
+public:
+    explicit P2Quantile(float quantile);
+
+    void add(float x);
+    void reset();
+
+    float getEstimate() const;
+    uint64_t getCount() const { return count; }
+
+private:
+    float parabolic(int i, int d) const;
+    float linear(int i, int d) const;
+
+    float p;
+    uint64_t count = 0;
+    float heights[5] = {};
+    float positions[5] = {};
+    float desired[5] = {};
+    float increments[5] = {};
+};
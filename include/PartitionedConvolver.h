@@ -0,0 +1,48 @@
+#pragma once
+
+#include <fftw3.h>
+#include <vector>
+#include <cstddef>
+
+// Uniformly partitioned overlap-save convolution: the filter is cut into
+// blocks of blockSize whose spectra are computed once, and each input block
+// costs one forward and one inverse FFT of 2 * blockSize plus a complex
+// multiply-add per partition against a frequency-domain delay line.
+class PartitionedConvolver {
+public:
+    // planFlags: FFTW_ESTIMATE for one-shot use, where measuring would take
+    // longer than the convolution
+    PartitionedConvolver(const float* filter, size_t length, int blockSize, unsigned planFlags = FFTW_MEASURE);
+    ~PartitionedConvolver();
+
+    PartitionedConvolver(const PartitionedConvolver&) = delete;
+    PartitionedConvolver& operator=(const PartitionedConvolver&) = delete;
+
+    int getBlockSize() const { return blockSize; }
+
+    // blockSize samples in, the next blockSize samples of the convolution out
+    void process(const float* in, float* out);
+
+    // Full linear convolution of a whole signal, n + length - 1 samples.
+    // Starts from a cleared state.
+    std::vector<float> convolve(const float* input, size_t n);
+
+    void reset();
+
+private:
+    int blockSize;
+    int fftSize;
+    int numBins;
+    int numPartitions;
+    size_t filterLength;
+
+    fftwf_complex* partitions;  // numPartitions spectra, 1/fftSize folded in
+    fftwf_complex* delayLine;   // Input spectra, newest at delayPos
+    fftwf_complex* spectrum;
+    fftwf_complex* accumulator;
+    float* timeBuffer;          // Previous block then current block
+    float* outputBuffer;
+    fftwf_plan forwardPlan;
+    fftwf_plan inversePlan;
+    int delayPos = 0;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+// The K strongest local maxima of a magnitude spectrum. Bins are offered
+// from the loop that computes the magnitudes, so finding peaks costs no
+// extra pass. Candidates are kept in a bounded min-heap. The survivors are
+// refined to sub-bin frequency by Gaussian interpolation (a parabola through
+// the log magnitudes).
+class PeakFinder {
+public:
+    struct Peak {
+        float frequency;  // Hz
+        float magnitude;  // Linear, same units as the spectrum
+    };
+
+    // threshold: linear magnitude below which maxima are ignored
+    PeakFinder(int maxPeaks, float threshold);
+
+    // Starts a new frame
+    void begin() { heap.clear(); }
+
+    // Considers bin as a peak; mag[bin - 1] and mag[bin + 1] must be valid
+    void offer(const float* mag, int bin) {
+        float m = mag[bin];
+        if (m < threshold || m <= mag[bin - 1] || m < mag[bin + 1]) return;
+
+        if (static_cast<int>(heap.size()) < maxPeaks) {
+            heap.push_back({m, bin});
+            std::push_heap(heap.begin(), heap.end(), weaker);
+        } else if (m > heap.front().magnitude) {
+            std::pop_heap(heap.begin(), heap.end(), weaker);
+            heap.back() = {m, bin};
+            std::push_heap(heap.begin(), heap.end(), weaker);
+        }
+    }
+
+    // offer() for bins first .. last - 1; out of line, so every spectrum
+    // loop runs the same scan code
+    void offerRange(const float* mag, int first, int last);
+
+    // Refines the candidates of the frame, strongest first
+    void finish(const float* mag, float binStartFreq, float binWidth);
+
+    const std::vector<Peak>& getPeaks() const { return peaks; }
+
+private:
+    struct Candidate {
+        float magnitude;
+        int bin;
+    };
+
+    // Min-heap order: the weakest candidate sits at the front
+    static bool weaker(const Candidate& a, const Candidate& b) { return a.magnitude > b.magnitude; }
+
+    int maxPeaks;
+    float threshold;
+    std::vector<Candidate> heap;
+    std::vector<Peak> peaks;
+};
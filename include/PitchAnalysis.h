@@ -0,0 +1,58 @@
+#pragma once
+
+#include <fftw3.h>
+#include <vector>
+#include <array>
+
+// Monophonic pitch by YIN (de Cheveigne & Kawahara, 2002) on the unwindowed
+// analysis frame. The difference function comes from a cross-correlation
+// computed with FFTW, so a frame costs two real FFTs instead of O(N^2).
+class PitchDetector {
+public:
+    PitchDetector(int frameSize, int sampleRate, float minFreq, float maxFreq);
+    ~PitchDetector();
+
+    PitchDetector(const PitchDetector&) = delete;
+    PitchDetector& operator=(const PitchDetector&) = delete;
+
+    void process(const float* frame);
+
+    float getPitch() const { return pitch; }            // Hz, 0 when unvoiced
+    float getConfidence() const { return confidence; }  // 0-1
+
+private:
+    int frameSize;
+    int window;  // Integration window, half the frame
+    int sampleRate;
+    int minLag;
+    int maxLag;
+
+    float* timeBuffer;
+    fftwf_complex* frameSpectrum;
+    fftwf_complex* headSpectrum;
+    fftwf_plan forwardPlan;
+    fftwf_plan inversePlan;
+
+    std::vector<float> energy;      // Prefix sums of x^2
+    std::vector<float> difference;  // Cumulative mean normalized difference
+
+    float pitch = 0.0f;
+    float confidence = 0.0f;
+};
+
+// 12-bin chromagram (C = 0) from a power spectrum, through a precomputed
+// bin to pitch class map. Bins wider than half a semitone are left out.
+class Chromagram {
+public:
+    Chromagram(int numBins, float binStartFreq, float binWidth);
+
+    void process(const float* power);
+
+    // Normalized so the strongest class is 1
+    const std::array<float, 12>& getChroma() const { return chroma; }
+
+private:
+    int firstBin = 0;
+    std::vector<int> pitchClass;  // Per bin from firstBin
+    std::array<float, 12> chroma{};
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Config.h"
+#include "WindowFunction.h"
+#include "BandLayout.h"
+#include <fftw3.h>
+#include <vector>
+#include <memory>
+
+// Reassigned band power: each bin's energy is moved to the instantaneous
+// frequency and group delay estimated from two extra transforms, one with
+// the time derivative of the window and one with the time-weighted window,
+// run as a single batched FFTW plan. Energy is scattered into a fine
+// frequency grid of cellsPerBin cells per bin that maps onto the display
+// bands, so tones land in one band and transients in one frame.
+class ReassignedSpectrum {
+public:
+    // hop: samples between frames; energy is owned by the frame whose
+    // center is nearest to its reassigned time
+    ReassignedSpectrum(int fftSize, int sampleRate, int hop, std::shared_ptr<const WindowFunction> window,
+                       std::shared_ptr<const BandLayout> layout, FrequencyWeighting weighting);
+    ~ReassignedSpectrum();
+
+    ReassignedSpectrum(const ReassignedSpectrum&) = delete;
+    ReassignedSpectrum& operator=(const ReassignedSpectrum&) = delete;
+
+    // frame: unwindowed input, spectrum: its transform with the window,
+    // power: that spectrum per bin in power units (fftSize / 2 bins)
+    void process(const float* frame, const fftwf_complex* spectrum, const float* power);
+
+    // Weighted power per band of the latest frame
+    const std::vector<float>& getBandPower() const { return bandPower; }
+
+    static constexpr int kCellsPerBin = 8;
+
+private:
+    int fftSize;
+    int numBins;
+    int numBands;
+    float hop;
+    std::shared_ptr<const WindowFunction> window;
+
+    std::vector<float> derivativeWindow;  // dh/dn
+    std::vector<float> rampWindow;        // (n - N/2) * h
+
+    // Both windowed frames back to back, transformed by one plan
+    float* input;
+    fftwf_complex* output;
+    fftwf_plan plan;
+
+    // Cell tables, index 0 and the last entry catch positions off the grid.
+    // A second copy cellStride entries on maps to the next frame's bands.
+    // Slots numBands and 2 * numBands + 1 discard energy.
+    int cellStride;
+    std::vector<int> cellBands;
+    std::vector<float> cellGains;
+
+    std::vector<int> slots;  // Cell per bin, into the tables above
+    std::vector<float> values;
+    std::vector<float> histogram;  // This frame's bands, then the next frame's
+    std::vector<float> carry;      // Energy reassigned ahead of the previous frame
+    std::vector<float> bandPower;
+};
@@ -16,9 +16,18 @@ public:
 
     void renderSpectrum(const std::vector<float>& bands, const std::vector<float>& peaks, bool showPeaks);
 
+    // Translucent column over one band
+    void renderHighlight(int band, int numBands, const std::array<uint8_t, 3>& color);
+
+    // Line through the bar centers, same 0-1 levels as the bars
+    void renderTrace(const std::vector<float>& levels, const std::array<uint8_t, 3>& color);
+
     bool shouldClose() const { return closeRequested; }
     void pollEvents();
 
+    // Key presses since the last call, other than the quit keys
+    std::vector<SDL_Keycode> takeKeyPresses();
+
     int getWidth() const { return width; }
     int getHeight() const { return height; }
 
@@ -26,6 +35,7 @@ private:
     void renderBar(float x, float y, float width, float height, float level);
     void renderPeak(float x, float y, float width);
     std::array<float, 3> interpolateColor(float level) const;
+    float barStep(int numBands, float& barWidth) const;
 
     SDL_Window* window = nullptr;
     SDL_GLContext glContext = nullptr;
@@ -36,4 +46,5 @@ private:
 
     VisualizationConfig visConfig;
     bool closeRequested = false;
+    std::vector<SDL_Keycode> keyPresses;
 };
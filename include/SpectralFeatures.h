@@ -0,0 +1,33 @@
+#pragma once
+
+#include "SpectrumSnapshot.h"
+#include "SpscQueue.h"
+#include <vector>
+
+// Per-frame spectral descriptors over the bins between minFreq and maxFreq.
+// Centroid, spread, flatness, flux and crest come from one fused pass over
+// the power and magnitude spectra with lane accumulators; the rolloff needs the total
+// first and is a short cumulative scan after it. No extra FFTs.
+class SpectralFeatures {
+public:
+    SpectralFeatures(int numBins, float binStartFreq, float binWidth, float minFreq, float maxFreq);
+
+    // power and magnitudes of the same frame, as the analyzer holds them
+    void process(const float* power, const float* magnitudes, double time);
+
+    const SpectralFeatureFrame& getFrame() const { return frame; }
+
+    // Every frame is also queued for export; lock-free, one consumer only.
+    // Frames are dropped while the queue is full.
+    bool popFrame(SpectralFeatureFrame& out) { return frames.pop(out); }
+
+private:
+    int firstBin;
+    int numBins;
+    float binStartFreq;
+    float binWidth;
+
+    std::vector<float> previous;  // Magnitudes of the previous frame, for the flux
+    SpectralFeatureFrame frame;
+    SpscQueue<SpectralFeatureFrame, 256> frames;
+};
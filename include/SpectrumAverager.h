@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Config.h"
+#include <vector>
+#include <cstdint>
+
+// Long-term average of a power spectrum (Welch style): last N frames,
+// exponential with a time constant, or running mean since the last reset.
+class SpectrumAverager {
+public:
+    SpectrumAverager(AveragingMode mode, int numBins, int numFrames, float timeConstant);
+
+    void update(const float* power, float dt);
+    void reset();
+
+    void setFrozen(bool frozen) { this->frozen = frozen; }
+    bool isFrozen() const { return frozen; }
+
+    const std::vector<float>& getAverage() const { return average; }
+    uint64_t getFrameCount() const { return frameCount; }
+
+private:
+    void rebuildSum();
+
+    AveragingMode mode;
+    int numBins;
+    int numFrames;
+    float timeConstant;
+    bool frozen = false;
+    uint64_t frameCount = 0;
+
+    std::vector<float> average;
+
+    // Linear mode: ring of the last numFrames spectra and their running sum
+    std::vector<float> history;
+    std::vector<double> sum;
+    int historyPos = 0;
+};
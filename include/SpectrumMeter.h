@@ -6,6 +6,9 @@
 #include "Renderer.h"
 #include <memory>
 #include <atomic>
+#include <chrono>
+#include <vector>
+#include <fstream>
 
 class SpectrumMeter {
 public:
@@ -18,6 +21,14 @@ public:
 
 private:
     void onAudioData(const float* samples, size_t count);
+    void handleKeys();
+    using Clock = std::chrono::steady_clock;
+
+    void handleFeedbackEvents(Clock::time_point now);
+    void exportFeatures();
+    void renderTransfer();
+    void printMeters() const;
+    void printPitch() const;
 
     Config config;
 
@@ -25,5 +36,11 @@ private:
     std::unique_ptr<FFTAnalyzer> fftAnalyzer;
     std::unique_ptr<Renderer> renderer;
 
+    SpectrumSnapshot snapshot;
+    int meterPrintCount = 0;
+    std::vector<float> transferLevels;
+    std::vector<Clock::time_point> feedbackUntil;  // Per band highlight expiry
+    std::ofstream featuresFile;
+
     std::atomic<bool> running{false};
 };
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+struct SpectralPeak {
+    float frequency = 0.0f;  // Hz, sub-bin accurate
+    float levelDb = 0.0f;    // dBFS, unweighted
+};
+
+// Spectral descriptors of one frame, see SpectralFeatures
+struct SpectralFeatureFrame {
+    double timestamp = 0.0;  // Audio time, seconds
+    float centroid = 0.0f;   // Hz
+    float spread = 0.0f;     // Hz, standard deviation around the centroid
+    float flatness = 0.0f;   // Geometric over arithmetic mean of the power, 0-1
+    float rolloff = 0.0f;    // Hz below which 85% of the power lies
+    float flux = 0.0f;       // Rise in magnitude since the previous frame, relative
+    float crest = 0.0f;      // dB, largest bin over the mean power
+};
+
+// Analysis results published once per frame. The analysis thread fills it,
+// the render thread only ever reads a copy.
+struct SpectrumSnapshot {
+    uint64_t frame = 0;      // Frames analyzed so far
+    double timestamp = 0.0;  // Seconds of audio analyzed at the end of the frame
+
+    std::vector<float> bands;  // Display levels 0-1 after ballistics
+    std::vector<float> peaks;  // Peak hold levels 0-1
+    float minDb = 0.0f;        // dBFS at level 0 and 1, changes with auto-range
+    float maxDb = 0.0f;
+
+    // Long-term power average (empty when averaging is off)
+    std::vector<float> average;
+    uint64_t averageFrames = 0;
+    bool averageFrozen = false;
+
+    // EBU R128 loudness, -inf until measured or with the meter off
+    float momentaryLoudness = -std::numeric_limits<float>::infinity();   // LUFS
+    float shortTermLoudness = -std::numeric_limits<float>::infinity();   // LUFS
+    float integratedLoudness = -std::numeric_limits<float>::infinity();  // LUFS
+    float loudnessRange = 0.0f;                                          // LU
+
+    // True peak per channel in dBTP, -inf with the meter off
+    std::array<float, 2> truePeak = {-std::numeric_limits<float>::infinity(),
+                                     -std::numeric_limits<float>::infinity()};     // Since the previous frame
+    std::array<float, 2> maxTruePeak = {-std::numeric_limits<float>::infinity(),
+                                        -std::numeric_limits<float>::infinity()};  // Since reset
+    std::array<uint64_t, 2> truePeakOvers = {0, 0};
+
+    // Stereo stage (empty / 0 when off)
+    float correlation = 0.0f;   // -1 .. +1
+    std::vector<float> mid;     // Display levels 0-1
+    std::vector<float> side;    // Display levels 0-1
+    std::vector<float> balance; // -1 left .. +1 right per band
+
+    // Transfer function per band (empty when off)
+    std::vector<float> transferDb;     // |H1| in dB
+    std::vector<float> transferPhase;  // Degrees
+    std::vector<float> coherence;      // 0-1
+    int transferDelay = 0;             // Samples compensated
+
+    // Strongest spectral peaks, loudest first (empty when off)
+    std::vector<SpectralPeak> spectralPeaks;
+
+    // Onsets and tempo (0 when off); onsetCount tells consumers a new onset happened
+    uint64_t onsetCount = 0;
+    double onsetTime = 0.0;     // Audio time of the last onset, seconds
+    float onsetStrength = 0.0f; // Flux over threshold
+    float tempo = 0.0f;         // BPM, 0 until estimated
+    double tempoTime = 0.0;     // Audio time of the tempo estimate
+
+    // Pitch and chroma (0 when off)
+    float pitch = 0.0f;            // Hz, 0 when unvoiced
+    float pitchConfidence = 0.0f;  // 0-1
+    std::array<float, 12> chroma{};  // C, C#, ... B, strongest = 1
+
+    // Spectral features of the latest frame (zero when off)
+    SpectralFeatureFrame features;
+
+    // Harmonic distortion (zero when off)
+    float fundamental = 0.0f;  // Hz, 0 with no signal
+    float fundamentalDb = -std::numeric_limits<float>::infinity();  // dBFS
+    std::vector<float> harmonicsDb;  // dBc, 2nd harmonic first
+    float thd = 0.0f;   // Ratio
+    float thdN = 0.0f;  // Ratio
+    bool harmonicsResolved = true;  // False when harmonic lobes overlap, THD not measured
+
+    // Measurement traces (empty when traces are off or no reference is captured)
+    std::vector<float> maxHold;
+    std::vector<float> minHold;
+    std::vector<float> reference;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "WindowFunction.h"
+#include "BandLayout.h"
+#include <fftw3.h>
+#include <vector>
+#include <memory>
+
+// Stereo stage of the full-band FFT: both channels go through one complex
+// FFT (left real, right imaginary) and are separated by conjugate symmetry.
+// Gives mid and side band levels, per-band L/R balance and a phase
+// correlation meter. The mid spectrum is the mono downmix's spectrum, so the
+// analyzer takes it from here instead of running its own FFT.
+class StereoAnalyzer {
+public:
+    StereoAnalyzer(int fftSize, int sampleRate, std::shared_ptr<const WindowFunction> window,
+                   std::shared_ptr<const BandLayout> layout);
+    ~StereoAnalyzer();
+
+    StereoAnalyzer(const StereoAnalyzer&) = delete;
+    StereoAnalyzer& operator=(const StereoAnalyzer&) = delete;
+
+    // One frame of fftSize samples per channel, unwindowed. Writes the mid
+    // ((L + R) / 2) spectrum, fftSize / 2 + 1 bins, to midSpectrum.
+    void analyze(const float* left, const float* right, fftwf_complex* midSpectrum);
+
+    // -1 (out of phase) .. +1 (mono), 0 for silence
+    float getCorrelation() const { return correlation; }
+
+    // Linear band levels like FFTAnalyzer's power aggregation
+    const std::vector<float>& getMid() const { return mid; }
+    const std::vector<float>& getSide() const { return side; }
+
+    // -1 (left only) .. +1 (right only) per band
+    const std::vector<float>& getBalance() const { return balance; }
+
+private:
+    int fftSize;
+    float hopSeconds;
+    std::shared_ptr<const WindowFunction> window;
+    std::shared_ptr<const BandLayout> layout;
+
+    fftwf_complex* packed;
+    fftwf_plan fftPlan;
+
+    // Per bin power
+    std::vector<float> leftPower;
+    std::vector<float> rightPower;
+    std::vector<float> midPower;
+    std::vector<float> sidePower;
+
+    std::vector<float> mid;
+    std::vector<float> side;
+    std::vector<float> balance;
+    std::vector<float> scratch;
+    float correlation = 0.0f;
+};
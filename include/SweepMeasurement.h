@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Config.h"
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// Impulse response measurement with an exponential sine sweep (Farina).
+// The recording is deconvolved with the time-reversed sweep, amplitude
+// tilted by -6 dB/octave, which turns the sweep into a band-limited
+// impulse. Harmonic distortion lands at fixed times before the linear
+// response, so each order comes out as its own impulse response.
+class SweepMeasurement {
+public:
+    explicit SweepMeasurement(const SweepConfig& config);
+
+    // Test signal: faded sweep at the configured level followed by silence
+    std::vector<float> generateSignal() const;
+
+    // Deconvolves a mono recording of the test signal; false if it holds no response
+    bool analyze(const float* recording, size_t numSamples);
+
+    // prefix_ir.wav, prefix_h2.wav..., prefix_response.csv (magnitude,
+    // phase and distortion per excitation frequency) and prefix_etc.csv
+    bool writeResults(const std::string& prefix) const;
+
+    const std::vector<float>& getImpulse() const { return impulse; }
+    const std::vector<std::vector<float>>& getHarmonicImpulses() const { return harmonicImpulses; }  // 2nd first
+    const std::vector<float>& getEtc() const { return etc; }  // dB re peak, per IR sample
+    long getLatency() const { return latency; }  // Samples from the start of the recording
+
+private:
+    void normalizeInverse();
+    void computeEtc();
+
+    SweepConfig config;
+    double rate;  // L = T / ln(f2 / f1), seconds per neper of frequency
+    std::vector<float> sweep;
+    std::vector<float> inverse;
+
+    std::vector<float> impulse;
+    std::vector<std::vector<float>> harmonicImpulses;
+    std::vector<float> etc;
+    long latency = 0;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+
+// Measurement traces kept next to the live bands, all in dBFS like the
+// ballistics: max-hold and min-hold since the last reset, and a reference
+// captured on demand.
+class TraceSet {
+public:
+    explicit TraceSet(int numBands);
+
+    void update(const float* levels);
+    void resetHolds();
+
+    void captureReference(const std::vector<float>& levels);
+    void clearReference();
+
+    const std::vector<float>& getMaxHold() const { return maxHold; }
+    const std::vector<float>& getMinHold() const { return minHold; }
+    const std::vector<float>& getReference() const { return reference; }  // Empty until captured
+
+private:
+    int numBands;
+    bool holdsValid = false;
+
+    std::vector<float> maxHold;
+    std::vector<float> minHold;
+    std::vector<float> reference;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "WindowFunction.h"
+#include "BandLayout.h"
+#include <fftw3.h>
+#include <vector>
+#include <memory>
+
+// Dual-channel measurement between a reference and a measurement channel of
+// the stereo input: averaged auto and cross spectra give the H1 transfer
+// function (magnitude and phase) and the coherence per bin, averaged into
+// bands weighted by the reference power. The delay between the channels is
+// found by GCC-PHAT on the averaged cross spectrum and compensated before
+// framing, so phase and coherence are not smeared by the acoustic delay.
+class TransferAnalyzer {
+public:
+    // referenceChannel: 0 = left, 1 = right; averageTime: seconds (exponential);
+    // layout: band rows without frequency weighting
+    TransferAnalyzer(int fftSize, int sampleRate, std::shared_ptr<const WindowFunction> window,
+                     std::shared_ptr<const BandLayout> layout, int referenceChannel,
+                     float averageTime, bool autoDelay);
+    ~TransferAnalyzer();
+
+    TransferAnalyzer(const TransferAnalyzer&) = delete;
+    TransferAnalyzer& operator=(const TransferAnalyzer&) = delete;
+
+    // Interleaved stereo input
+    void process(const float* samples, size_t frames);
+
+    // Restarts the averages and the delay search
+    void reset();
+
+    const std::vector<float>& getMagnitudeDb() const { return magnitudeDb; }
+    const std::vector<float>& getPhase() const { return phase; }  // Degrees
+    const std::vector<float>& getCoherence() const { return coherence; }
+
+    // Measurement channel delay in samples, negative if it leads
+    int getDelay() const { return delay; }
+
+private:
+    void analyze();
+    void estimateDelay();
+    void updateBands();
+
+    int fftSize;
+    float alpha;  // Per-frame averaging weight
+    bool autoDelay;
+    int referenceChannel;
+    std::shared_ptr<const WindowFunction> window;
+    std::shared_ptr<const BandLayout> layout;
+
+    // Delay lines that align the two channels
+    std::vector<float> referenceLine;
+    std::vector<float> measurementLine;
+    size_t linePos = 0;
+    int delay = 0;
+
+    std::vector<float> reference;
+    std::vector<float> measurement;
+    size_t bufferPos = 0;
+    int framesAveraged = 0;
+
+    fftwf_complex* packed;
+    fftwf_plan fftPlan;
+    fftwf_complex* correlation;
+    fftwf_plan inversePlan;
+
+    // Averaged one-sided spectra, bins 0..fftSize/2
+    std::vector<float> gxx;
+    std::vector<float> gyy;
+    std::vector<float> gxyRe;
+    std::vector<float> gxyIm;
+
+    // Per-bin Gxx * |H|^2 and Gxx * coherence
+    std::vector<float> responsePower;
+    std::vector<float> coherentPower;
+
+    std::vector<float> bandGxx;
+    std::vector<float> bandGxyRe;
+    std::vector<float> bandGxyIm;
+    std::vector<float> bandResponsePower;
+    std::vector<float> bandCoherentPower;
+
+    std::vector<float> magnitudeDb;
+    std::vector<float> phase;
+    std::vector<float> coherence;
+};
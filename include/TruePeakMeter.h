@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+// True-peak meter for interleaved stereo (ITU-R BS.1770 annex 2): each
+// channel is oversampled 4x with a polyphase FIR and the peak is taken over
+// all phases. Coefficients are stored tap-major so the four phases of one
+// tap are computed together.
+class TruePeakMeter {
+public:
+    static constexpr int kChannels = 2;
+    static constexpr int kFactor = 4;
+    static constexpr int kTapsPerPhase = 12;
+
+    // overThresholdDb: dBTP above which an over is counted
+    explicit TruePeakMeter(float overThresholdDb);
+
+    void process(const float* samples, size_t frames);
+    void reset();
+
+    // Starts a new block peak, the previous one stays readable until then
+    void startBlock();
+
+    // Linear peak values
+    float getBlockPeak(int channel) const { return blockPeak[channel]; }
+    float getMaxPeak(int channel) const { return maxPeak[channel]; }
+
+    // Excursions above the threshold, each counted once however long it lasts
+    uint64_t getOvers(int channel) const { return overs[channel]; }
+
+    // Delay of the interpolated signal in input samples
+    static constexpr int getLatency() { return kTapsPerPhase / 2; }
+
+private:
+    std::array<float, kTapsPerPhase * kFactor> coefficients;  // [tap][phase]
+
+    // Doubled delay line per channel, newest sample at historyPos
+    float history[kChannels][2 * kTapsPerPhase] = {};
+    int historyPos = 0;
+
+    float overThreshold;
+    std::array<float, kChannels> blockPeak{};
+    std::array<float, kChannels> maxPeak{};
+    std::array<uint64_t, kChannels> overs{};
+    std::array<bool, kChannels> inOver{};
+};
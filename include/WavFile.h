@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Interleaved float audio read from or written to a RIFF/WAVE file
+struct WavData {
+    int sampleRate = 0;
+    int channels = 0;
+    std::vector<float> samples;
+
+    size_t frames() const { return channels > 0 ? samples.size() / channels : 0; }
+};
+
+// Reads 16/24/32-bit PCM and 32/64-bit float, plain or extensible format.
+// Prints the reason and returns false on failure.
+bool readWav(const std::string& path, WavData& out);
+
+// Writes 32-bit float
+bool writeWav(const std::string& path, const WavData& data);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Config.h"
+#include <array>
+#include <vector>
+#include <memory>
+
+// Cosine-sum windows, w(x) = a0 - a1 cos(2 pi x) + a2 cos(4 pi x) - ...
+namespace windows {
+    constexpr std::array<double, 2> kHann = {0.5, 0.5};
+    constexpr std::array<double, 4> kBlackmanHarris = {0.35875, 0.48829, 0.14128, 0.01168};
+    constexpr std::array<double, 5> kFlatTop = {0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368};
+
+    // cos(2 pi turns) by Taylor series after reduction to half a turn,
+    // usable in constant expressions
+    constexpr double cosTurns(double turns) {
+        turns -= static_cast<long long>(turns);
+        if (turns > 0.5) turns -= 1.0;
+        const double x = 2.0 * 3.14159265358979323846 * turns;
+        double term = 1.0;
+        double sum = 1.0;
+        for (int k = 1; k < 16; ++k) {
+            term *= -x * x / ((2 * k - 1) * (2 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    // Periodic cosine-sum table of Size points, built at compile time
+    template <int Size, size_t Terms>
+    constexpr std::array<float, Size> cosineSumTable(const std::array<double, Terms>& a) {
+        std::array<float, Size> table{};
+        for (int i = 0; i < Size; ++i) {
+            double w = 0.0;
+            double sign = 1.0;
+            for (size_t k = 0; k < Terms; ++k) {
+                w += sign * a[k] * cosTurns(static_cast<double>((static_cast<long long>(k) * i) % Size) / Size);
+                sign = -sign;
+            }
+            table[i] = static_cast<float>(w);
+        }
+        return table;
+    }
+}
+
+// Analysis window table with its gain corrections. Tables are built once per
+// (type, size, parameter) and shared by every analyzer that asks for them.
+class WindowFunction {
+public:
+    static std::shared_ptr<const WindowFunction> get(WindowType type, int size, float param);
+
+    // Window from the spectrum config at the given size
+    static std::shared_ptr<const WindowFunction> get(const SpectrumConfig& config, int size);
+
+    WindowFunction(WindowType type, int size, float param);
+
+    WindowType getType() const { return type; }
+    const float* data() const { return coefficients.data(); }
+    int size() const { return static_cast<int>(coefficients.size()); }
+
+    // Mean of the window, the amplitude a bin-centered tone is scaled by
+    float getCoherentGain() const { return coherentGain; }
+
+    // Equivalent noise bandwidth in bins
+    float getEnbw() const { return enbw; }
+
+    // |X| * amplitudeScale = peak amplitude of a bin-centered sine (1.0 = 0 dBFS)
+    float getAmplitudeScale() const { return amplitudeScale; }
+
+    // |X|^2 * powerScale = power per bin, summing to A^2 over a tone's main lobe
+    float getPowerScale() const { return powerScale; }
+
+private:
+    WindowType type;
+    std::vector<float> coefficients;
+    float coherentGain;
+    float enbw;
+    float amplitudeScale;
+    float powerScale;
+};
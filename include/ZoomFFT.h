@@ -0,0 +1,69 @@
+#pragma once
+
+#include "WindowFunction.h"
+#include <fftw3.h>
+#include <vector>
+#include <cstddef>
+
+// Zoom FFT: mixes the band of interest down to 0 Hz, low-pass filters and
+// decimates it, then runs a small complex FFT over the narrow band.
+// Output magnitudes are ordered by frequency starting at getStartFreq().
+class ZoomFFT {
+public:
+    ZoomFFT(int sampleRate, float minFreq, float maxFreq, std::shared_ptr<const WindowFunction> window);
+    ~ZoomFFT();
+
+    ZoomFFT(const ZoomFFT&) = delete;
+    ZoomFFT& operator=(const ZoomFFT&) = delete;
+
+    // Decimation factor the zoom would use for this range (< 2 means no gain)
+    static int decimationFor(int sampleRate, float minFreq, float maxFreq);
+
+    // Feed mono samples, stopping as soon as a new spectrum is ready so the
+    // caller sees every frame. Returns true if one is; consumed is set to the
+    // number of samples used, the rest go in the next call.
+    bool process(const float* samples, size_t count, size_t& consumed);
+
+    const std::vector<float>& getMagnitudes() const { return magnitudes; }
+    const std::vector<float>& getPower() const { return power; }
+    float getStartFreq() const { return centerFreq - outputRate * 0.5f; }
+    float getBinWidth() const { return outputRate / fftSize; }
+    int getDecimation() const { return decimation; }
+
+private:
+    void designFilter(float span);
+    void pushDecimated(float re, float im);
+    void computeSpectrum();
+
+    int sampleRate;
+    int fftSize;
+    float centerFreq;
+    int decimation;
+    float outputRate;
+
+    // Numerically controlled oscillator for e^{-j*2*pi*fc*n/fs}
+    float oscRe = 1.0f;
+    float oscIm = 0.0f;
+    float stepRe;
+    float stepIm;
+    int renormCounter = 0;
+
+    // Decimating FIR, delay line stored twice so the taps read one contiguous span
+    std::vector<float> taps;
+    std::vector<float> delayRe;
+    std::vector<float> delayIm;
+    size_t delayPos = 0;
+    int decimationPhase = 0;
+
+    std::vector<float> frameRe;
+    std::vector<float> frameIm;
+    size_t framePos = 0;
+
+    std::shared_ptr<const WindowFunction> window;
+    fftwf_complex* fftInput;
+    fftwf_complex* fftOutput;
+    fftwf_plan fftPlan;
+
+    std::vector<float> magnitudes;
+    std::vector<float> power;
+};
@@ -2,8 +2,8 @@
 #include <iostream>
 #include <cstring>
 
-AudioCapture::AudioCapture(int sampleRate, int bufferSize)
-    : sampleRate(sampleRate), bufferSize(bufferSize) {
+AudioCapture::AudioCapture(int sampleRate, int bufferSize, bool captureSink)
+    : sampleRate(sampleRate), bufferSize(bufferSize), captureSink(captureSink) {
 }
 
 AudioCapture::~AudioCapture() {
@@ -46,7 +46,7 @@ bool AudioCapture::initialize() {
         PW_KEY_MEDIA_TYPE, "Audio",
         PW_KEY_MEDIA_CATEGORY, "Capture",
         PW_KEY_MEDIA_ROLE, "Music",
-        PW_KEY_STREAM_CAPTURE_SINK, "true",  // CRITICAL: Capture from sink (playback) not source (mic)
+        PW_KEY_STREAM_CAPTURE_SINK, captureSink ? "true" : "false",  // Sink monitor (playback) or source (mic)
         nullptr
     );
 
@@ -0,0 +1,48 @@
+#include "AutoRange.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    // Silence and gated bands say nothing about the material's range
+    constexpr float kSilenceDb = -150.0f;
+
+    // Narrowest range shown, keeps a steady tone from filling the screen
+    constexpr float kMinSpan = 20.0f;
+
+    // Samples a window needs before its estimate is used
+    constexpr uint64_t kMinSamples = 64;
+}
+
+AutoRange::AutoRange(const SpectrumConfig& config)
+    : low(config.autoRangeLow / 100.0f), high(config.autoRangeHigh / 100.0f),
+      window(config.autoRangeWindow), smoothingTime(config.autoRangeTime),
+      targetMin(config.minDb), targetMax(config.maxDb),
+      minDb(config.minDb), maxDb(config.maxDb) {
+}
+
+void AutoRange::update(const float* levelsDb, int count, float dt) {
+    for (int i = 0; i < count; ++i) {
+        if (levelsDb[i] > kSilenceDb) {
+            low.add(levelsDb[i]);
+            high.add(levelsDb[i]);
+        }
+    }
+
+    // The first window steers the range as it fills, later ones when complete
+    elapsed += dt;
+    bool windowDone = elapsed >= window;
+    if ((windowDone || !haveTarget) && low.getCount() >= kMinSamples) {
+        targetMax = high.getEstimate();
+        targetMin = std::min(low.getEstimate(), targetMax - kMinSpan);
+    }
+    if (windowDone) {
+        haveTarget = haveTarget || low.getCount() >= kMinSamples;
+        elapsed = 0.0f;
+        low.reset();
+        high.reset();
+    }
+
+    float alpha = 1.0f - std::exp(-dt / smoothingTime);
+    minDb += (targetMin - minDb) * alpha;
+    maxDb += (targetMax - maxDb) * alpha;
+}
@@ -0,0 +1,86 @@
+#include "Ballistics.h"
+#include <cmath>
+#include <algorithm>
+
+Ballistics::Params Ballistics::fromConfig(const SpectrumConfig& config, float hopSeconds) {
+    Params params;
+    const float dbRange = config.maxDb - config.minDb;
+
+    switch (config.ballistics) {
+        case BallisticsPreset::Smooth:
+            // Same response as the old per-frame factor at the configured hop
+            if (config.smoothing > 0.0f && config.smoothing < 1.0f) {
+                params.attackTime = -hopSeconds / std::log(config.smoothing);
+                params.releaseTime = params.attackTime;
+            }
+            break;
+        case BallisticsPreset::Vu:
+            // IEC 60268-17: 99% of a step in 300 ms, symmetric
+            params.attackTime = 0.065f;
+            params.releaseTime = 0.065f;
+            break;
+        case BallisticsPreset::PpmDin:
+            // IEC 60268-10 Type I: -1 dB at 10 ms burst, 20 dB fall in 1.5 s
+            params.attackTime = 0.0017f;
+            params.releaseRate = 20.0f / 1.5f;
+            break;
+        case BallisticsPreset::PpmBbc:
+            // IEC 60268-10 Type IIa: 10 ms integration, 24 dB fall in 2.8 s
+            params.attackTime = 0.0035f;
+            params.releaseRate = 24.0f / 2.8f;
+            break;
+        case BallisticsPreset::Custom:
+            params.attackTime = config.attackTime;
+            params.releaseTime = config.releaseTime;
+            params.releaseRate = config.releaseRate;
+            break;
+    }
+
+    params.peakHoldTime = config.peakHoldTime;
+    // peak_fall_time is top to bottom of the configured range
+    params.peakFallRate = config.peakFallTime > 0.0f ? dbRange / config.peakFallTime : 1e9f;
+    return params;
+}
+
+Ballistics::Ballistics(int numBands, const Params& params, float floorDb)
+    : params(params) {
+    levels.resize(numBands, floorDb);
+    peaks.resize(numBands, floorDb);
+    peakAge.resize(numBands, 0.0f);
+}
+
+void Ballistics::update(const float* input, float dt) {
+    const int numBands = static_cast<int>(levels.size());
+    const float attack = params.attackTime > 0.0f ? 1.0f - std::exp(-dt / params.attackTime) : 1.0f;
+    const float release = params.releaseTime > 0.0f ? 1.0f - std::exp(-dt / params.releaseTime) : 1.0f;
+    const float releaseStep = params.releaseRate * dt;
+    const float peakStep = params.peakFallRate * dt;
+    const float hold = params.peakHoldTime;
+
+    // Branch-free bodies so each loop vectorizes across bands
+    if (params.releaseRate > 0.0f) {
+        for (int i = 0; i < numBands; ++i) {
+            float x = input[i];
+            float l = levels[i];
+            float rise = l + (x - l) * attack;
+            float fall = std::max(x, l - releaseStep);
+            levels[i] = x > l ? rise : fall;
+        }
+    } else {
+        for (int i = 0; i < numBands; ++i) {
+            float x = input[i];
+            float l = levels[i];
+            levels[i] = l + (x - l) * (x > l ? attack : release);
+        }
+    }
+
+    for (int i = 0; i < numBands; ++i) {
+        float l = levels[i];
+        float p = peaks[i];
+        bool newPeak = l >= p;
+        float age = newPeak ? 0.0f : peakAge[i] + dt;
+        float falling = std::max(l, p - peakStep);
+        peaks[i] = newPeak ? l : (age > hold ? falling : p);
+        peakAge[i] = age;
+    }
+}
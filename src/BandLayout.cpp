@@ -0,0 +1,198 @@
+#include "BandLayout.h"
+#include "DspKernels.h"
+#include "FrequencyWeighting.h"
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // Frequency warps for the perceptual scales, each with its inverse
+    float hzToMel(float f) { return 2595.0f * std::log10(1.0f + f / 700.0f); }
+    float melToHz(float m) { return 700.0f * (std::pow(10.0f, m / 2595.0f) - 1.0f); }
+
+    // Traunmueller (1990)
+    float hzToBark(float f) { return 26.81f * f / (1960.0f + f) - 0.53f; }
+    float barkToHz(float z) { return 1960.0f * (z + 0.53f) / (26.28f - z); }
+
+    // Glasberg & Moore (1990) ERB-rate
+    float hzToErb(float f) { return 21.4f * std::log10(1.0f + 0.00437f * f); }
+    float erbToHz(float e) { return (std::pow(10.0f, e / 21.4f) - 1.0f) / 0.00437f; }
+
+    float warp(BandScale scale, float f) {
+        switch (scale) {
+            case BandScale::Linear: return f;
+            case BandScale::Mel: return hzToMel(f);
+            case BandScale::Bark: return hzToBark(f);
+            case BandScale::Erb: return hzToErb(f);
+            default: return std::log10(f);
+        }
+    }
+
+    float unwarp(BandScale scale, float x) {
+        switch (scale) {
+            case BandScale::Linear: return x;
+            case BandScale::Mel: return melToHz(x);
+            case BandScale::Bark: return barkToHz(x);
+            case BandScale::Erb: return erbToHz(x);
+            default: return std::pow(10.0f, x);
+        }
+    }
+}
+
+std::shared_ptr<const BandLayout> BandLayout::get(const SpectrumConfig& config, float binStartFreq,
+                                                  float binWidth, int numBins) {
+    using Key = std::tuple<BandScale, BandShape, FrequencyWeighting, int, float, float,
+                           std::vector<float>, float, float, int>;
+    static std::mutex cacheMutex;
+    static std::map<Key, std::weak_ptr<const BandLayout>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    Key key{config.bandScale, config.bandShape, config.freqWeighting, config.bands,
+            config.minFreq, config.maxFreq, config.bandEdges, binStartFreq, binWidth, numBins};
+    if (auto cached = cache[key].lock()) {
+        return cached;
+    }
+
+    auto layout = std::make_shared<const BandLayout>(config, binStartFreq, binWidth, numBins);
+    cache[key] = layout;
+    return layout;
+}
+
+BandLayout::BandLayout(const SpectrumConfig& config, float binStartFreq, float binWidth, int numBins) {
+    buildBands(config);
+    buildRows(config.bandShape, binStartFreq, binWidth, numBins);
+    applyWeighting(config.freqWeighting, binStartFreq, binWidth);
+
+    std::cout << "Band layout: " << getNumBands() << " bands, "
+              << weights.size() << " weights" << std::endl;
+}
+
+void BandLayout::buildBands(const SpectrumConfig& config) {
+    if (config.bandScale == BandScale::ThirdOctave) {
+        // IEC 61260 base-2 third octaves around 1 kHz that fall inside the range
+        int first = static_cast<int>(std::ceil(3.0f * std::log2(config.minFreq / 1000.0f)));
+        int last = static_cast<int>(std::floor(3.0f * std::log2(config.maxFreq / 1000.0f)));
+        for (int k = first; k <= last; ++k) {
+            float center = 1000.0f * std::pow(2.0f, k / 3.0f);
+            centers.push_back(center);
+            low.push_back(center * std::pow(2.0f, -1.0f / 6.0f));
+            high.push_back(center * std::pow(2.0f, 1.0f / 6.0f));
+        }
+        return;
+    }
+
+    if (config.bandScale == BandScale::Custom && config.bandEdges.size() >= 2) {
+        for (size_t i = 0; i + 1 < config.bandEdges.size(); ++i) {
+            low.push_back(config.bandEdges[i]);
+            high.push_back(config.bandEdges[i + 1]);
+            centers.push_back(std::sqrt(config.bandEdges[i] * config.bandEdges[i + 1]));
+        }
+        return;
+    }
+
+    if (config.bandScale == BandScale::Custom) {
+        std::cerr << "band_edges needs at least two edges, using log layout" << std::endl;
+    }
+
+    // Equal steps on the warped scale
+    float warpMin = warp(config.bandScale, config.minFreq);
+    float warpMax = warp(config.bandScale, config.maxFreq);
+    float step = (warpMax - warpMin) / config.bands;
+
+    for (int band = 0; band < config.bands; ++band) {
+        low.push_back(unwarp(config.bandScale, warpMin + band * step));
+        high.push_back(unwarp(config.bandScale, warpMin + (band + 1) * step));
+        centers.push_back(unwarp(config.bandScale, warpMin + (band + 0.5f) * step));
+    }
+}
+
+void BandLayout::buildRows(BandShape shape, float binStartFreq, float binWidth, int numBins) {
+    const int numBands = getNumBands();
+    spans.resize(numBands);
+    rowOffsets.resize(numBands + 1);
+    rowWeights.resize(numBands);
+
+    auto binOf = [&](float freq) {
+        return static_cast<int>((freq - binStartFreq) / binWidth);
+    };
+    auto binAtOrAbove = [&](float freq) {
+        return static_cast<int>(std::ceil((freq - binStartFreq) / binWidth));
+    };
+
+    rowOffsets[0] = 0;
+    for (int band = 0; band < numBands; ++band) {
+        Span& span = spans[band];
+        span.centerBin = (centers[band] - binStartFreq) / binWidth;
+        span.narrow = (high[band] - low[band]) < binWidth;
+
+        if (shape == BandShape::Triangular) {
+            // Feet at the neighbouring centers, peak of 1 at this center
+            float lowerFoot = band > 0 ? centers[band - 1] : low[band];
+            float upperFoot = band + 1 < numBands ? centers[band + 1] : high[band];
+            int binLow = std::clamp(binOf(lowerFoot) + 1, 0, numBins);
+            int binHigh = std::clamp(binOf(upperFoot), -1, numBins - 1);
+
+            span.first = binLow;
+            span.count = 0;
+            for (int bin = binLow; bin <= binHigh; ++bin) {
+                float freq = binStartFreq + bin * binWidth;
+                float weight = freq < centers[band]
+                    ? (freq - lowerFoot) / (centers[band] - lowerFoot)
+                    : (upperFoot - freq) / (upperFoot - centers[band]);
+                weights.push_back(std::max(0.0f, weight));
+                ++span.count;
+            }
+        } else {
+            // Half-open [low, high) so a bin on an edge belongs to one band only
+            int binLow = std::clamp(binAtOrAbove(low[band]), 0, numBins);
+            int binHigh = std::clamp(binAtOrAbove(high[band]), binLow, numBins);
+
+            span.first = binLow;
+            span.count = binHigh - binLow;
+            weights.insert(weights.end(), span.count, 1.0f);
+        }
+
+        rowOffsets[band + 1] = static_cast<int>(weights.size());
+        rowWeights[band] = dsp::sum(weights.data() + rowOffsets[band], span.count);
+    }
+}
+
+void BandLayout::applyWeighting(FrequencyWeighting weighting, float binStartFreq, float binWidth) {
+    // Evaluated once per bin here instead of per band every frame
+    powerWeights.resize(weights.size());
+    magnitudeWeights.resize(weights.size());
+
+    for (int band = 0; band < getNumBands(); ++band) {
+        const Span& span = spans[band];
+        for (int i = 0; i < span.count; ++i) {
+            size_t index = rowOffsets[band] + i;
+            float gain = frequencyWeightGain(weighting, binStartFreq + (span.first + i) * binWidth);
+            magnitudeWeights[index] = weights[index] * gain;
+            powerWeights[index] = weights[index] * gain * gain;
+        }
+    }
+
+    centerGains.resize(getNumBands());
+    for (int band = 0; band < getNumBands(); ++band) {
+        centerGains[band] = frequencyWeightGain(weighting, centers[band]);
+    }
+}
+
+void BandLayout::applyPower(const float* power, float* out) const {
+    const int numBands = getNumBands();
+    for (int band = 0; band < numBands; ++band) {
+        const Span& span = spans[band];
+        out[band] = dsp::dot(powerWeights.data() + rowOffsets[band], power + span.first, span.count);
+    }
+}
+
+void BandLayout::applyMagnitude(const float* magnitudes, float* out) const {
+    const int numBands = getNumBands();
+    for (int band = 0; band < numBands; ++band) {
+        const Span& span = spans[band];
+        out[band] = dsp::dot(magnitudeWeights.data() + rowOffsets[band], magnitudes + span.first, span.count);
+    }
+}
@@ -0,0 +1,140 @@
+#include "BeatTracker.h"
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+    // Log compression of the magnitudes before differencing
+    constexpr float kCompression = 100.0f;
+
+    // Adaptive threshold: mean of the last frames plus a fraction of their spread
+    constexpr float kThresholdSeconds = 0.25f;
+
+    // Onsets closer than this are one onset
+    constexpr double kMinInterval = 0.05;
+
+    // Tempo: envelope length, update interval and the searched range
+    constexpr float kEnvelopeSeconds = 6.0f;
+    constexpr float kTempoInterval = 0.5f;
+    constexpr float kMinBpm = 60.0f;
+    constexpr float kMaxBpm = 200.0f;
+
+    // Log-Gaussian preference around 120 BPM against octave errors
+    constexpr float kPreferredBpm = 120.0f;
+    constexpr float kPreferenceOctaves = 1.0f;
+
+    int nextPowerOfTwo(int n) {
+        int p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+}
+
+BeatTracker::BeatTracker(int numBins, float framePeriod, float sensitivity)
+    : numBins(numBins), framePeriod(framePeriod), sensitivity(sensitivity) {
+    previous.resize(numBins, 0.0f);
+    recent.resize(std::max(4, static_cast<int>(kThresholdSeconds / framePeriod)), 0.0f);
+    envelope.resize(static_cast<size_t>(kEnvelopeSeconds / framePeriod), 0.0f);
+
+    // Zero padded to twice the envelope so the autocorrelation does not wrap
+    acfSize = nextPowerOfTwo(2 * static_cast<int>(envelope.size()));
+    acfBuffer = fftwf_alloc_real(acfSize);
+    acfSpectrum = fftwf_alloc_complex(acfSize / 2 + 1);
+    forwardPlan = fftwf_plan_dft_r2c_1d(acfSize, acfBuffer, acfSpectrum, FFTW_MEASURE);
+    inversePlan = fftwf_plan_dft_c2r_1d(acfSize, acfSpectrum, acfBuffer, FFTW_MEASURE);
+}
+
+BeatTracker::~BeatTracker() {
+    fftwf_destroy_plan(forwardPlan);
+    fftwf_destroy_plan(inversePlan);
+    fftwf_free(acfBuffer);
+    fftwf_free(acfSpectrum);
+}
+
+bool BeatTracker::update(const float* magnitudes, double time) {
+    // Half-wave rectified log spectral flux
+    float flux = 0.0f;
+    for (int bin = 0; bin < numBins; ++bin) {
+        float value = std::log1p(kCompression * magnitudes[bin]);
+        flux += std::max(0.0f, value - previous[bin]);
+        previous[bin] = value;
+    }
+    flux /= numBins;
+
+    // Threshold from the frames before this one
+    float mean = std::accumulate(recent.begin(), recent.end(), 0.0f) / recent.size();
+    float deviation = 0.0f;
+    for (float value : recent) deviation += std::fabs(value - mean);
+    deviation /= recent.size();
+    float threshold = mean + sensitivity * deviation + 1e-4f;
+
+    recent[recentPos] = flux;
+    recentPos = (recentPos + 1) % recent.size();
+
+    envelope[envelopePos] = flux;
+    envelopePos = (envelopePos + 1) % envelope.size();
+    envelopeFilled = std::min(envelopeFilled + 1, envelope.size());
+
+    if (++framesSinceTempo * framePeriod >= kTempoInterval && envelopeFilled == envelope.size()) {
+        framesSinceTempo = 0;
+        estimateTempo(time);
+    }
+
+    // Rising edge through the threshold, decided on this frame
+    bool above = flux > threshold;
+    bool onset = above && !wasAbove && (onsetCount == 0 || time - onsetTime >= kMinInterval);
+    wasAbove = above;
+
+    if (onset) {
+        ++onsetCount;
+        onsetTime = time;
+        onsetStrength = flux / threshold;
+    }
+    return onset;
+}
+
+void BeatTracker::estimateTempo(double time) {
+    // Envelope oldest first, mean removed, zero padded
+    const size_t length = envelope.size();
+    float mean = std::accumulate(envelope.begin(), envelope.end(), 0.0f) / length;
+    for (size_t i = 0; i < length; ++i) {
+        acfBuffer[i] = envelope[(envelopePos + i) % length] - mean;
+    }
+    std::fill(acfBuffer + length, acfBuffer + acfSize, 0.0f);
+
+    // Autocorrelation = inverse FFT of the power spectrum
+    fftwf_execute(forwardPlan);
+    for (int k = 0; k <= acfSize / 2; ++k) {
+        float re = acfSpectrum[k][0];
+        float im = acfSpectrum[k][1];
+        acfSpectrum[k][0] = re * re + im * im;
+        acfSpectrum[k][1] = 0.0f;
+    }
+    fftwf_execute(inversePlan);
+    if (acfBuffer[0] <= 0.0f) return;
+
+    int minLag = std::max(1, static_cast<int>(60.0f / (kMaxBpm * framePeriod)));
+    int maxLag = std::min(static_cast<int>(length) - 2, static_cast<int>(60.0f / (kMinBpm * framePeriod)) + 1);
+
+    int bestLag = 0;
+    float bestScore = 0.0f;
+    for (int lag = minLag; lag <= maxLag; ++lag) {
+        // Unbiased estimate, then the tempo preference
+        float value = acfBuffer[lag] / (length - lag);
+        float octaves = std::log2(60.0f / (lag * framePeriod) / kPreferredBpm) / kPreferenceOctaves;
+        float score = value * std::exp(-0.5f * octaves * octaves);
+        if (score > bestScore) {
+            bestScore = score;
+            bestLag = lag;
+        }
+    }
+    if (bestLag == 0) return;
+
+    // Parabolic refinement of the peak lag
+    float a = acfBuffer[bestLag - 1], b = acfBuffer[bestLag], c = acfBuffer[bestLag + 1];
+    float denom = a - 2.0f * b + c;
+    float offset = denom < 0.0f ? std::clamp(0.5f * (a - c) / denom, -0.5f, 0.5f) : 0.0f;
+
+    tempo = 60.0f / ((bestLag + offset) * framePeriod);
+    tempoTime = time;
+}
@@ -0,0 +1,182 @@
+#include "ChirpZ.h"
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    int nextPowerOfTwo(int n) {
+        int p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    // Grid spacing relative to the FFT bin width; fine enough that linear
+    // interpolation between grid points follows the window main lobe
+    constexpr int kOversampling = 8;
+}
+
+// Precomputed chirps and FFTW plans, shared by every transform with the same layout
+struct ChirpZ::Tables {
+    int convLength;
+    fftwf_complex* preChirp;        // e^{-j2*pi*n*f0/fs} * e^{-j*pi*n^2*a}, a = df/fs
+    fftwf_complex* filterSpectrum;  // FFT of e^{+j*pi*m^2*a}, scaled by 1/L for the inverse FFT
+    fftwf_complex* scratch;
+    fftwf_plan forwardPlan;
+    fftwf_plan backwardPlan;
+
+    ~Tables() {
+        fftwf_destroy_plan(forwardPlan);
+        fftwf_destroy_plan(backwardPlan);
+        fftwf_free(preChirp);
+        fftwf_free(filterSpectrum);
+        fftwf_free(scratch);
+    }
+};
+
+ChirpZ::ChirpZ(int frameSize, int sampleRate, float startFreq, float freqStep, int numPoints)
+    : frameSize(frameSize), numPoints(numPoints), startFreq(startFreq), freqStep(freqStep) {
+    tables = getTables(frameSize, sampleRate, startFreq, freqStep, numPoints);
+    work = fftwf_alloc_complex(tables->convLength);
+}
+
+ChirpZ::~ChirpZ() {
+    fftwf_free(work);
+}
+
+int ChirpZ::maxPointsFor(int frameSize) {
+    return 2 * nextPowerOfTwo(frameSize) - frameSize + 1;
+}
+
+std::shared_ptr<const ChirpZ::Tables> ChirpZ::getTables(int frameSize, int sampleRate,
+                                                         float startFreq, float freqStep, int numPoints) {
+    using Key = std::tuple<int, int, float, float, int>;
+    static std::mutex cacheMutex;
+    static std::map<Key, std::weak_ptr<const Tables>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    Key key{frameSize, sampleRate, startFreq, freqStep, numPoints};
+    if (auto cached = cache[key].lock()) {
+        return cached;
+    }
+
+    auto tables = std::make_shared<Tables>();
+    const int L = nextPowerOfTwo(frameSize + numPoints - 1);
+    tables->convLength = L;
+    tables->preChirp = fftwf_alloc_complex(frameSize);
+    tables->filterSpectrum = fftwf_alloc_complex(L);
+    tables->scratch = fftwf_alloc_complex(L);
+    tables->forwardPlan = fftwf_plan_dft_1d(L, tables->scratch, tables->scratch, FFTW_FORWARD, FFTW_MEASURE);
+    tables->backwardPlan = fftwf_plan_dft_1d(L, tables->scratch, tables->scratch, FFTW_BACKWARD, FFTW_MEASURE);
+
+    // Chirp phases grow with n^2, so reduce them in double before going to float
+    const double a = static_cast<double>(freqStep) / sampleRate;
+    auto chirpPhase = [a](long m) {
+        return M_PI * std::fmod(static_cast<double>(m) * m * a, 2.0);
+    };
+
+    for (int n = 0; n < frameSize; ++n) {
+        double phase = -2.0 * M_PI * std::fmod(static_cast<double>(n) * startFreq / sampleRate, 1.0)
+                       - chirpPhase(n);
+        tables->preChirp[n][0] = static_cast<float>(std::cos(phase));
+        tables->preChirp[n][1] = static_cast<float>(std::sin(phase));
+    }
+
+    // h[m] for m = 0..M-1 at the front, m = -(N-1)..-1 wrapped to the back
+    auto* h = tables->scratch;
+    std::fill(&h[0][0], &h[0][0] + 2 * L, 0.0f);
+    for (int m = 0; m < numPoints; ++m) {
+        double phase = chirpPhase(m);
+        h[m][0] = static_cast<float>(std::cos(phase));
+        h[m][1] = static_cast<float>(std::sin(phase));
+    }
+    for (int m = 1; m < frameSize; ++m) {
+        double phase = chirpPhase(m);
+        h[L - m][0] = static_cast<float>(std::cos(phase));
+        h[L - m][1] = static_cast<float>(std::sin(phase));
+    }
+    fftwf_execute(tables->forwardPlan);
+
+    // Fold the inverse FFT scale in here
+    const float scale = 1.0f / static_cast<float>(L);
+    for (int i = 0; i < L; ++i) {
+        tables->filterSpectrum[i][0] = h[i][0] * scale;
+        tables->filterSpectrum[i][1] = h[i][1] * scale;
+    }
+
+    cache[key] = tables;
+    return tables;
+}
+
+void ChirpZ::process(const float* frame, float* magnitudes) {
+    const int L = tables->convLength;
+    const auto* pre = tables->preChirp;
+    const auto* H = tables->filterSpectrum;
+
+    for (int n = 0; n < frameSize; ++n) {
+        work[n][0] = frame[n] * pre[n][0];
+        work[n][1] = frame[n] * pre[n][1];
+    }
+    std::fill(&work[frameSize][0], &work[0][0] + 2 * L, 0.0f);
+
+    fftwf_execute_dft(tables->forwardPlan, work, work);
+
+    for (int i = 0; i < L; ++i) {
+        float re = work[i][0] * H[i][0] - work[i][1] * H[i][1];
+        float im = work[i][0] * H[i][1] + work[i][1] * H[i][0];
+        work[i][0] = re;
+        work[i][1] = im;
+    }
+
+    fftwf_execute_dft(tables->backwardPlan, work, work);
+
+    // The post-chirp only rotates the phase, magnitudes don't need it
+    for (int k = 0; k < numPoints; ++k) {
+        magnitudes[k] = std::sqrt(work[k][0] * work[k][0] + work[k][1] * work[k][1]);
+    }
+}
+
+ChirpZBands::ChirpZBands(int frameSize, int sampleRate, const std::vector<float>& frequencies, float scale)
+    : frequencies(frequencies), scale(scale) {
+
+    const float step = static_cast<float>(sampleRate) / (frameSize * kOversampling);
+    const int maxPoints = ChirpZ::maxPointsFor(frameSize);
+    const float maxSpan = (maxPoints - 2) * step;
+
+    size_t gridSize = 0;
+    size_t i = 0;
+    while (i < frequencies.size()) {
+        size_t first = i;
+        float start = frequencies[first];
+        while (i < frequencies.size() && frequencies[i] - start <= maxSpan) ++i;
+
+        // One extra point past the last frequency for interpolation
+        int numPoints = static_cast<int>(std::ceil((frequencies[i - 1] - start) / step)) + 2;
+        segments.push_back({std::make_unique<ChirpZ>(frameSize, sampleRate, start, step, numPoints),
+                            first, i - first});
+        gridSize = std::max(gridSize, static_cast<size_t>(numPoints));
+    }
+
+    grid.resize(gridSize, 0.0f);
+    magnitudes.resize(frequencies.size(), 0.0f);
+
+    std::cout << "Chirp-Z bands: " << frequencies.size() << " frequencies in "
+              << segments.size() << " segments" << std::endl;
+}
+
+void ChirpZBands::process(const float* frame) {
+    for (auto& segment : segments) {
+        ChirpZ& czt = *segment.transform;
+        czt.process(frame, grid.data());
+
+        for (size_t j = 0; j < segment.numFreqs; ++j) {
+            size_t index = segment.firstFreq + j;
+            float pos = (frequencies[index] - czt.getStartFreq()) / czt.getFreqStep();
+            int i0 = std::min(static_cast<int>(pos), czt.getNumPoints() - 2);
+            float t = pos - i0;
+            magnitudes[index] = (grid[i0] * (1.0f - t) + grid[i0 + 1] * t) * scale;
+        }
+    }
+}
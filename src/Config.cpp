@@ -28,10 +28,151 @@ bool Config::load(const std::string& filename) {
             if (spec["smoothing"]) spectrum.smoothing = spec["smoothing"].as<float>();
             if (spec["peak_hold_enabled"]) spectrum.peakHoldEnabled = spec["peak_hold_enabled"].as<bool>();
             if (spec["peak_fall_time"]) spectrum.peakFallTime = spec["peak_fall_time"].as<float>();
+            if (spec["peak_hold_time"]) spectrum.peakHoldTime = spec["peak_hold_time"].as<float>();
+            if (spec["ballistics"]) {
+                auto preset = spec["ballistics"].as<std::string>();
+                if (preset == "smooth") spectrum.ballistics = BallisticsPreset::Smooth;
+                else if (preset == "vu") spectrum.ballistics = BallisticsPreset::Vu;
+                else if (preset == "ppm_din") spectrum.ballistics = BallisticsPreset::PpmDin;
+                else if (preset == "ppm_bbc") spectrum.ballistics = BallisticsPreset::PpmBbc;
+                else if (preset == "custom") spectrum.ballistics = BallisticsPreset::Custom;
+                else std::cerr << "Unknown ballistics '" << preset << "', using smooth" << std::endl;
+            }
+            if (spec["window"]) {
+                auto window = spec["window"].as<std::string>();
+                if (window == "hann") spectrum.window = WindowType::Hann;
+                else if (window == "blackman_harris") spectrum.window = WindowType::BlackmanHarris;
+                else if (window == "kaiser") spectrum.window = WindowType::Kaiser;
+                else if (window == "flat_top") spectrum.window = WindowType::FlatTop;
+                else if (window == "gaussian") spectrum.window = WindowType::Gaussian;
+                else std::cerr << "Unknown window '" << window << "', using hann" << std::endl;
+            }
+            if (spec["kaiser_beta"]) spectrum.kaiserBeta = spec["kaiser_beta"].as<float>();
+            if (spec["gaussian_sigma"]) spectrum.gaussianSigma = spec["gaussian_sigma"].as<float>();
+            if (spec["averaging"]) {
+                auto mode = spec["averaging"].as<std::string>();
+                if (mode == "off") spectrum.averaging = AveragingMode::Off;
+                else if (mode == "linear") spectrum.averaging = AveragingMode::Linear;
+                else if (mode == "exponential") spectrum.averaging = AveragingMode::Exponential;
+                else if (mode == "infinite") spectrum.averaging = AveragingMode::Infinite;
+                else std::cerr << "Unknown averaging '" << mode << "', using off" << std::endl;
+            }
+            if (spec["average_frames"]) spectrum.averageFrames = spec["average_frames"].as<int>();
+            if (spec["average_time"]) spectrum.averageTime = spec["average_time"].as<float>();
+            if (spec["traces"]) spectrum.traces = spec["traces"].as<bool>();
+            if (spec["attack_time"]) spectrum.attackTime = spec["attack_time"].as<float>();
+            if (spec["release_time"]) spectrum.releaseTime = spec["release_time"].as<float>();
+            if (spec["release_rate"]) spectrum.releaseRate = spec["release_rate"].as<float>();
             if (spec["min_db"]) spectrum.minDb = spec["min_db"].as<float>();
             if (spec["max_db"]) spectrum.maxDb = spec["max_db"].as<float>();
             if (spec["noise_threshold"]) spectrum.noiseThreshold = spec["noise_threshold"].as<float>();
-            if (spec["freq_weighting"]) spectrum.freqWeighting = spec["freq_weighting"].as<bool>();
+            if (spec["noise_floor"]) {
+                auto mode = spec["noise_floor"].as<std::string>();
+                if (mode == "off") spectrum.noiseFloor = NoiseFloorMode::Off;
+                else if (mode == "gate") spectrum.noiseFloor = NoiseFloorMode::Gate;
+                else if (mode == "subtract") spectrum.noiseFloor = NoiseFloorMode::Subtract;
+                else std::cerr << "Unknown noise_floor '" << mode << "', using off" << std::endl;
+            }
+            if (spec["noise_floor_window"]) spectrum.noiseFloorWindow = spec["noise_floor_window"].as<float>();
+            if (spec["noise_floor_margin"]) spectrum.noiseFloorMargin = spec["noise_floor_margin"].as<float>();
+            if (spec["noise_floor_max"]) spectrum.noiseFloorMax = spec["noise_floor_max"].as<float>();
+            if (spec["loudness"]) spectrum.loudness = spec["loudness"].as<bool>();
+            if (spec["true_peak"]) spectrum.truePeak = spec["true_peak"].as<bool>();
+            if (spec["true_peak_over"]) spectrum.truePeakOver = spec["true_peak_over"].as<float>();
+            if (spec["stereo"]) spectrum.stereo = spec["stereo"].as<bool>();
+            if (spec["transfer"]) spectrum.transfer = spec["transfer"].as<bool>();
+            if (spec["transfer_reference"]) {
+                auto channel = spec["transfer_reference"].as<std::string>();
+                if (channel == "left") spectrum.transferReference = 0;
+                else if (channel == "right") spectrum.transferReference = 1;
+                else std::cerr << "Unknown transfer_reference '" << channel << "', using left" << std::endl;
+            }
+            if (spec["transfer_average_time"]) spectrum.transferAverageTime = spec["transfer_average_time"].as<float>();
+            if (spec["transfer_auto_delay"]) spectrum.transferAutoDelay = spec["transfer_auto_delay"].as<bool>();
+            if (spec["peak_count"]) spectrum.peakCount = spec["peak_count"].as<int>();
+            if (spec["peak_threshold"]) spectrum.peakThreshold = spec["peak_threshold"].as<float>();
+            if (spec["feedback"]) spectrum.feedback = spec["feedback"].as<bool>();
+            if (spec["feedback_hops"]) spectrum.feedbackHops = spec["feedback_hops"].as<int>();
+            if (spec["feedback_ratio"]) spectrum.feedbackRatio = spec["feedback_ratio"].as<float>();
+            if (spec["feedback_growth"]) spectrum.feedbackGrowth = spec["feedback_growth"].as<float>();
+            if (spec["beats"]) spectrum.beats = spec["beats"].as<bool>();
+            if (spec["onset_sensitivity"]) spectrum.onsetSensitivity = spec["onset_sensitivity"].as<float>();
+            if (spec["pitch"]) spectrum.pitch = spec["pitch"].as<bool>();
+            if (spec["pitch_min_freq"]) spectrum.pitchMinFreq = spec["pitch_min_freq"].as<float>();
+            if (spec["pitch_max_freq"]) spectrum.pitchMaxFreq = spec["pitch_max_freq"].as<float>();
+            if (spec["chroma"]) spectrum.chroma = spec["chroma"].as<bool>();
+            if (spec["features"]) spectrum.features = spec["features"].as<bool>();
+            if (spec["features_file"]) spectrum.featuresFile = spec["features_file"].as<std::string>();
+            if (spec["harmonics"]) spectrum.harmonics = spec["harmonics"].as<bool>();
+            if (spec["harmonic_min_freq"]) spectrum.harmonicMinFreq = spec["harmonic_min_freq"].as<float>();
+            if (spec["harmonic_max_freq"]) spectrum.harmonicMaxFreq = spec["harmonic_max_freq"].as<float>();
+            if (spec["harmonic_count"]) spectrum.harmonicCount = spec["harmonic_count"].as<int>();
+            if (spec["auto_range"]) spectrum.autoRange = spec["auto_range"].as<bool>();
+            if (spec["auto_range_low"]) spectrum.autoRangeLow = spec["auto_range_low"].as<float>();
+            if (spec["auto_range_high"]) spectrum.autoRangeHigh = spec["auto_range_high"].as<float>();
+            if (spec["auto_range_window"]) spectrum.autoRangeWindow = spec["auto_range_window"].as<float>();
+            if (spec["auto_range_time"]) spectrum.autoRangeTime = spec["auto_range_time"].as<float>();
+            if (spec["freq_weighting"]) {
+                // Older configs use a bool, true meant A-weighting style
+                auto weighting = spec["freq_weighting"].as<std::string>();
+                if (weighting == "a" || weighting == "A" || weighting == "true") spectrum.freqWeighting = FrequencyWeighting::A;
+                else if (weighting == "b" || weighting == "B") spectrum.freqWeighting = FrequencyWeighting::B;
+                else if (weighting == "c" || weighting == "C") spectrum.freqWeighting = FrequencyWeighting::C;
+                else if (weighting == "z" || weighting == "Z" || weighting == "false") spectrum.freqWeighting = FrequencyWeighting::Z;
+                else if (weighting == "itu468") spectrum.freqWeighting = FrequencyWeighting::Itu468;
+                else std::cerr << "Unknown freq_weighting '" << weighting << "', using A" << std::endl;
+            }
+            if (spec["zoom_fft"]) spectrum.zoomFFT = spec["zoom_fft"].as<bool>();
+            if (spec["zoom_fft_size"]) spectrum.zoomFFTSize = spec["zoom_fft_size"].as<int>();
+            if (spec["czt_bands"]) spectrum.cztBands = spec["czt_bands"].as<bool>();
+            if (spec["band_aggregation"]) {
+                auto mode = spec["band_aggregation"].as<std::string>();
+                if (mode == "mean") spectrum.bandAggregation = BandAggregation::Mean;
+                else if (mode == "power" || mode == "rms") spectrum.bandAggregation = BandAggregation::Power;
+                else if (mode == "max") spectrum.bandAggregation = BandAggregation::Max;
+                else if (mode == "interpolate") spectrum.bandAggregation = BandAggregation::Interpolate;
+                else if (mode == "reassigned") spectrum.bandAggregation = BandAggregation::Reassigned;
+                else std::cerr << "Unknown band_aggregation '" << mode << "', using mean" << std::endl;
+            }
+            if (spec["band_layout"]) {
+                auto scale = spec["band_layout"].as<std::string>();
+                if (scale == "log") spectrum.bandScale = BandScale::Log;
+                else if (scale == "linear") spectrum.bandScale = BandScale::Linear;
+                else if (scale == "mel") spectrum.bandScale = BandScale::Mel;
+                else if (scale == "bark") spectrum.bandScale = BandScale::Bark;
+                else if (scale == "erb") spectrum.bandScale = BandScale::Erb;
+                else if (scale == "third_octave") spectrum.bandScale = BandScale::ThirdOctave;
+                else if (scale == "custom") spectrum.bandScale = BandScale::Custom;
+                else std::cerr << "Unknown band_layout '" << scale << "', using log" << std::endl;
+            }
+            if (spec["band_shape"]) {
+                auto shape = spec["band_shape"].as<std::string>();
+                if (shape == "rectangular") spectrum.bandShape = BandShape::Rectangular;
+                else if (shape == "triangular") spectrum.bandShape = BandShape::Triangular;
+                else std::cerr << "Unknown band_shape '" << shape << "', using rectangular" << std::endl;
+            }
+            if (spec["band_edges"]) {
+                // Each pair of edges is a CSR row, so they must be positive and strictly rising
+                auto edges = spec["band_edges"].as<std::vector<float>>();
+                bool valid = true;
+                for (size_t i = 0; i < edges.size() && valid; ++i) {
+                    if (!(edges[i] > 0.0f)) {
+                        std::cerr << "band_edges[" << i << "] = " << edges[i] << " Hz is not positive";
+                        valid = false;
+                    } else if (i > 0 && edges[i] <= edges[i - 1]) {
+                        std::cerr << "band_edges[" << i << "] = " << edges[i] << " Hz does not rise above "
+                                  << edges[i - 1] << " Hz";
+                        valid = false;
+                    }
+                }
+                if (valid) {
+                    spectrum.bandEdges = edges;
+                } else {
+                    std::cerr << ", ignoring band_edges and using log layout" << std::endl;
+                    spectrum.bandEdges.clear();
+                    if (spectrum.bandScale == BandScale::Custom) spectrum.bandScale = BandScale::Log;
+                }
+            }
         }
 
         // Visualization config
@@ -57,6 +198,46 @@ bool Config::load(const std::string& filename) {
                 for (size_t i = 0; i < 3 && i < color.size(); ++i)
                     visualization.peakColor[i] = static_cast<uint8_t>(color[i]);
             }
+            if (vis["average_color"]) {
+                auto color = vis["average_color"].as<std::vector<int>>();
+                for (size_t i = 0; i < 3 && i < color.size(); ++i)
+                    visualization.averageColor[i] = static_cast<uint8_t>(color[i]);
+            }
+            if (vis["max_hold_color"]) {
+                auto color = vis["max_hold_color"].as<std::vector<int>>();
+                for (size_t i = 0; i < 3 && i < color.size(); ++i)
+                    visualization.maxHoldColor[i] = static_cast<uint8_t>(color[i]);
+            }
+            if (vis["min_hold_color"]) {
+                auto color = vis["min_hold_color"].as<std::vector<int>>();
+                for (size_t i = 0; i < 3 && i < color.size(); ++i)
+                    visualization.minHoldColor[i] = static_cast<uint8_t>(color[i]);
+            }
+            if (vis["reference_color"]) {
+                auto color = vis["reference_color"].as<std::vector<int>>();
+                for (size_t i = 0; i < 3 && i < color.size(); ++i)
+                    visualization.referenceColor[i] = static_cast<uint8_t>(color[i]);
+            }
+            if (vis["side_color"]) {
+                auto color = vis["side_color"].as<std::vector<int>>();
+                for (size_t i = 0; i < 3 && i < color.size(); ++i)
+                    visualization.sideColor[i] = static_cast<uint8_t>(color[i]);
+            }
+            if (vis["transfer_color"]) {
+                auto color = vis["transfer_color"].as<std::vector<int>>();
+                for (size_t i = 0; i < 3 && i < color.size(); ++i)
+                    visualization.transferColor[i] = static_cast<uint8_t>(color[i]);
+            }
+            if (vis["coherence_color"]) {
+                auto color = vis["coherence_color"].as<std::vector<int>>();
+                for (size_t i = 0; i < 3 && i < color.size(); ++i)
+                    visualization.coherenceColor[i] = static_cast<uint8_t>(color[i]);
+            }
+            if (vis["feedback_color"]) {
+                auto color = vis["feedback_color"].as<std::vector<int>>();
+                for (size_t i = 0; i < 3 && i < color.size(); ++i)
+                    visualization.feedbackColor[i] = static_cast<uint8_t>(color[i]);
+            }
             if (vis["bar_gap"]) visualization.barGap = vis["bar_gap"].as<int>();
             if (vis["bar_gradient"]) visualization.barGradient = vis["bar_gradient"].as<bool>();
         }
@@ -66,6 +247,35 @@ bool Config::load(const std::string& filename) {
             auto aud = config["audio"];
             if (aud["target_latency"]) audio.targetLatency = aud["target_latency"].as<int>();
             if (aud["buffer_size"]) audio.bufferSize = aud["buffer_size"].as<int>();
+            if (aud["capture_sink"]) audio.captureSink = aud["capture_sink"].as<bool>();
+        }
+
+        // Sweep measurement config
+        if (config["sweep"]) {
+            auto sw = config["sweep"];
+            if (sw["sample_rate"]) sweep.sampleRate = sw["sample_rate"].as<int>();
+            if (sw["start_freq"]) sweep.startFreq = sw["start_freq"].as<float>();
+            if (sw["end_freq"]) sweep.endFreq = sw["end_freq"].as<float>();
+            if (sw["duration"]) sweep.duration = sw["duration"].as<float>();
+            if (sw["level"]) sweep.level = sw["level"].as<float>();
+            if (sw["fade"]) sweep.fade = sw["fade"].as<float>();
+            if (sw["silence"]) sweep.silence = sw["silence"].as<float>();
+            if (sw["ir_length"]) sweep.irLength = sw["ir_length"].as<float>();
+            if (sw["harmonics"]) sweep.harmonics = sw["harmonics"].as<int>();
+            if (sw["channel"]) sweep.channel = sw["channel"].as<int>();
+        }
+
+        // Decay analysis config
+        if (config["decay"]) {
+            auto dec = config["decay"];
+            if (dec["csd_gate"]) decay.csdGate = dec["csd_gate"].as<float>();
+            if (dec["csd_step"]) decay.csdStep = dec["csd_step"].as<float>();
+            if (dec["csd_slices"]) decay.csdSlices = dec["csd_slices"].as<int>();
+            if (dec["csd_rise"]) decay.csdRise = dec["csd_rise"].as<float>();
+            if (dec["csd_points"]) decay.csdPoints = dec["csd_points"].as<int>();
+            if (dec["min_freq"]) decay.minFreq = dec["min_freq"].as<float>();
+            if (dec["max_freq"]) decay.maxFreq = dec["max_freq"].as<float>();
+            if (dec["threads"]) decay.threads = dec["threads"].as<int>();
         }
 
         return true;
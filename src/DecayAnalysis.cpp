@@ -0,0 +1,297 @@
+#include "DecayAnalysis.h"
+#include <fftw3.h>
+#include <cmath>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+namespace {
+    // Fixed fall at the end of the gate, as a fraction of it
+    constexpr float kFallFraction = 0.1f;
+
+    // Smoothing of the waterfall, half-width in octaves
+    constexpr float kSmoothingOctaves = 1.0f / 48.0f;
+
+    // Octave crossover half-width; neighbouring bands overlap by twice this
+    constexpr float kCrossoverOctaves = 0.25f;
+
+    // Decay fit limits in dB below the start of the EDC
+    struct Fit {
+        float from;
+        float to;
+    };
+    constexpr Fit kEdt = {0.0f, -10.0f};
+    constexpr Fit kT20 = {-5.0f, -25.0f};
+    constexpr Fit kT30 = {-5.0f, -35.0f};
+
+    // Noise floor from the tail of the response, truncation 5 dB above it
+    constexpr float kNoiseTail = 0.1f;
+    constexpr float kTruncationMargin = 3.1623f;
+    constexpr float kBlockSeconds = 0.01f;
+
+    int nextPowerOfTwo(size_t n) {
+        int p = 1;
+        while (static_cast<size_t>(p) < n) p <<= 1;
+        return p;
+    }
+
+    // Reverberation time from a least squares line through the EDC between two levels
+    float fitDecay(const std::vector<float>& edcDb, int sampleRate, Fit fit) {
+        size_t first = 0;
+        while (first < edcDb.size() && edcDb[first] > fit.from) ++first;
+        size_t last = first;
+        while (last < edcDb.size() && edcDb[last] > fit.to) ++last;
+        if (last >= edcDb.size() || last - first < 2) return 0.0f;
+
+        double n = 0.0, sumT = 0.0, sumL = 0.0, sumTT = 0.0, sumTL = 0.0;
+        for (size_t i = first; i <= last; ++i) {
+            double t = static_cast<double>(i) / sampleRate;
+            n += 1.0;
+            sumT += t;
+            sumL += edcDb[i];
+            sumTT += t * t;
+            sumTL += t * edcDb[i];
+        }
+        double slope = (n * sumTL - sumT * sumL) / (n * sumTT - sumT * sumT);
+        return slope < 0.0 ? static_cast<float>(-60.0 / slope) : 0.0f;
+    }
+
+    int threadCount(int configured, int jobs) {
+        int threads = configured > 0 ? configured : static_cast<int>(std::thread::hardware_concurrency());
+        return std::clamp(threads, 1, std::max(1, jobs));
+    }
+}
+
+size_t findDirectSound(const std::vector<float>& impulse) {
+    size_t peak = 0;
+    for (size_t i = 1; i < impulse.size(); ++i) {
+        if (std::fabs(impulse[i]) > std::fabs(impulse[peak])) peak = i;
+    }
+    return peak;
+}
+
+CumulativeSpectralDecay::CumulativeSpectralDecay(const DecayConfig& config, int sampleRate)
+    : config(config), sampleRate(sampleRate) {
+    gateLength = std::max(16, static_cast<int>(config.csdGate * sampleRate));
+    stepLength = std::max(1, static_cast<int>(config.csdStep * sampleRate));
+    riseLength = std::max(1, static_cast<int>(config.csdRise * sampleRate));
+    fallLength = static_cast<int>(kFallFraction * gateLength);
+
+    // Zero padded twice over for a smoother frequency axis
+    fftSize = 2 * nextPowerOfTwo(gateLength);
+
+    // Log-spaced grid, each point averaging the bins within its smoothing width
+    const float binWidth = static_cast<float>(sampleRate) / fftSize;
+    const float maxFreq = std::min(config.maxFreq, 0.5f * sampleRate);
+    const int numPoints = std::max(2, config.csdPoints);
+    for (int i = 0; i < numPoints; ++i) {
+        float freq = config.minFreq * std::pow(maxFreq / config.minFreq, static_cast<float>(i) / (numPoints - 1));
+        int low = static_cast<int>(std::ceil(freq * std::exp2(-kSmoothingOctaves) / binWidth));
+        int high = static_cast<int>(std::floor(freq * std::exp2(kSmoothingOctaves) / binWidth));
+        if (high < low) low = high = static_cast<int>(std::lround(freq / binWidth));
+        low = std::clamp(low, 0, fftSize / 2);
+        high = std::clamp(high, low, fftSize / 2);
+        frequencies.push_back(freq);
+        spans.push_back({low, high - low + 1});
+    }
+}
+
+void CumulativeSpectralDecay::process(const std::vector<float>& impulse, size_t start) {
+    // Slices must start before the fall window of the gate
+    const int maxSlices = std::max(1, (gateLength - fallLength - riseLength) / stepLength);
+    const int numSlices = std::clamp(config.csdSlices, 1, maxSlices);
+    const int numBins = fftSize / 2 + 1;
+
+    float* input = fftwf_alloc_real(static_cast<size_t>(numSlices) * fftSize);
+    fftwf_complex* output = fftwf_alloc_complex(static_cast<size_t>(numSlices) * numBins);
+
+    // One batched plan per thread over its contiguous run of slices. Planned
+    // here, since FFTW planning is not thread-safe; execution is.
+    const int threads = threadCount(config.threads, numSlices);
+    const int perThread = (numSlices + threads - 1) / threads;
+    std::vector<fftwf_plan> plans;
+    for (int first = 0; first < numSlices; first += perThread) {
+        int count = std::min(perThread, numSlices - first);
+        plans.push_back(fftwf_plan_many_dft_r2c(1, &fftSize, count,
+                                                input + static_cast<size_t>(first) * fftSize, nullptr, 1, fftSize,
+                                                output + static_cast<size_t>(first) * numBins, nullptr, 1, numBins,
+                                                FFTW_ESTIMATE));
+    }
+
+    slices.assign(numSlices, std::vector<float>(frequencies.size(), 0.0f));
+    sliceTimes.resize(numSlices);
+
+    auto worker = [&](int job) {
+        const int first = job * perThread;
+        const int last = std::min(first + perThread, numSlices);
+
+        for (int s = first; s < last; ++s) {
+            // Rise at this slice's start, the same fall at the gate end for every slice
+            float* x = input + static_cast<size_t>(s) * fftSize;
+            std::fill(x, x + fftSize, 0.0f);
+            const int begin = s * stepLength;
+            for (int i = begin; i < gateLength; ++i) {
+                size_t index = start + i;
+                if (index >= impulse.size()) break;
+                float w = 1.0f;
+                if (i - begin < riseLength) w = 0.5f - 0.5f * std::cos(static_cast<float>(M_PI) * (i - begin) / riseLength);
+                if (gateLength - i <= fallLength) w *= 0.5f - 0.5f * std::cos(static_cast<float>(M_PI) * (gateLength - i) / fallLength);
+                x[i - begin] = impulse[index] * w;
+            }
+        }
+
+        fftwf_execute(plans[job]);
+
+        for (int s = first; s < last; ++s) {
+            const fftwf_complex* X = output + static_cast<size_t>(s) * numBins;
+            for (size_t p = 0; p < spans.size(); ++p) {
+                float power = 0.0f;
+                for (int bin = spans[p].first; bin < spans[p].first + spans[p].count; ++bin) {
+                    power += X[bin][0] * X[bin][0] + X[bin][1] * X[bin][1];
+                }
+                slices[s][p] = power / spans[p].count;
+            }
+            sliceTimes[s] = static_cast<float>(s * stepLength) / sampleRate;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t job = 1; job < plans.size(); ++job) pool.emplace_back(worker, static_cast<int>(job));
+    worker(0);
+    for (auto& thread : pool) thread.join();
+
+    for (auto plan : plans) fftwf_destroy_plan(plan);
+    fftwf_free(input);
+    fftwf_free(output);
+
+    // Relative to the loudest point of the first slice
+    float reference = *std::max_element(slices[0].begin(), slices[0].end()) + 1e-30f;
+    for (auto& slice : slices) {
+        for (float& value : slice) value = 10.0f * std::log10(value / reference + 1e-30f);
+    }
+}
+
+bool CumulativeSpectralDecay::write(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Failed to create " << path << std::endl;
+        return false;
+    }
+
+    file << std::fixed << std::setprecision(2) << "time_ms";
+    for (float freq : frequencies) file << "," << freq;
+    file << "\n";
+    for (size_t s = 0; s < slices.size(); ++s) {
+        file << sliceTimes[s] * 1000.0f;
+        for (float value : slices[s]) file << "," << value;
+        file << "\n";
+    }
+    return true;
+}
+
+ReverberationTime::ReverberationTime(int sampleRate) : sampleRate(sampleRate) {
+}
+
+void ReverberationTime::process(const std::vector<float>& impulse, size_t start) {
+    bands.clear();
+    if (start >= impulse.size()) return;
+
+    std::vector<float> centers;
+    for (int k = -4; k <= 3; ++k) {
+        float center = 1000.0f * std::exp2(static_cast<float>(k));
+        if (center * std::exp2(0.5f + kCrossoverOctaves) < 0.5f * sampleRate) centers.push_back(center);
+    }
+    if (centers.empty()) return;
+
+    const size_t length = impulse.size() - start;
+    const int size = nextPowerOfTwo(2 * length);  // No circular wrap of the filter tails
+    const int numBins = size / 2 + 1;
+    const int numBands = static_cast<int>(centers.size());
+
+    float* time = fftwf_alloc_real(static_cast<size_t>(numBands) * size);
+    fftwf_complex* spectrum = fftwf_alloc_complex(numBins);
+    fftwf_complex* filtered = fftwf_alloc_complex(static_cast<size_t>(numBands) * numBins);
+    fftwf_plan forward = fftwf_plan_dft_r2c_1d(size, time, spectrum, FFTW_ESTIMATE);
+    fftwf_plan inverse = fftwf_plan_many_dft_c2r(1, &size, numBands, filtered, nullptr, 1, numBins,
+                                                 time, nullptr, 1, size, FFTW_ESTIMATE);
+
+    std::fill(time, time + size, 0.0f);
+    std::copy(impulse.begin() + start, impulse.end(), time);
+    fftwf_execute(forward);
+
+    // cos^2 / sin^2 crossovers in log frequency, so neighbouring bands sum to unit power
+    const float binWidth = static_cast<float>(sampleRate) / size;
+    for (int b = 0; b < numBands; ++b) {
+        fftwf_complex* Y = filtered + static_cast<size_t>(b) * numBins;
+        for (int bin = 0; bin < numBins; ++bin) {
+            float gain = 0.0f;
+            if (bin > 0) {
+                float distance = std::fabs(std::log2(bin * binWidth / centers[b]));
+                float x = std::clamp((distance - (0.5f - kCrossoverOctaves)) / (2.0f * kCrossoverOctaves), 0.0f, 1.0f);
+                gain = std::cos(0.5f * static_cast<float>(M_PI) * x) / size;
+            }
+            Y[bin][0] = spectrum[bin][0] * gain;
+            Y[bin][1] = spectrum[bin][1] * gain;
+        }
+    }
+    fftwf_execute(inverse);
+
+    const int blockLength = std::max(1, static_cast<int>(kBlockSeconds * sampleRate));
+    for (int b = 0; b < numBands; ++b) {
+        const float* y = time + static_cast<size_t>(b) * size;
+        std::vector<float> energy(length);
+        for (size_t i = 0; i < length; ++i) energy[i] = y[i] * y[i];
+
+        // Noise from the tail, then cut where the decay first reaches it
+        const size_t tail = std::max<size_t>(1, static_cast<size_t>(kNoiseTail * length));
+        double noise = 0.0;
+        for (size_t i = length - tail; i < length; ++i) noise += energy[i];
+        noise /= tail;
+
+        size_t truncation = length;
+        for (size_t block = 0; block + blockLength <= length; block += blockLength) {
+            double mean = 0.0;
+            for (int i = 0; i < blockLength; ++i) mean += energy[block + i];
+            mean /= blockLength;
+            if (mean < noise * kTruncationMargin) {
+                truncation = block;
+                break;
+            }
+        }
+
+        // Schroeder backward integral of the noise-compensated energy
+        std::vector<float> edcDb(truncation);
+        double integral = 0.0;
+        for (size_t i = truncation; i-- > 0;) {
+            integral += std::max(0.0, energy[i] - noise);
+            edcDb[i] = static_cast<float>(integral);
+        }
+        const double total = integral > 0.0 ? integral : 1.0;
+        for (float& value : edcDb) value = static_cast<float>(10.0 * std::log10(value / total + 1e-30));
+
+        bands.push_back({centers[b], fitDecay(edcDb, sampleRate, kEdt), fitDecay(edcDb, sampleRate, kT20),
+                         fitDecay(edcDb, sampleRate, kT30)});
+    }
+
+    fftwf_destroy_plan(forward);
+    fftwf_destroy_plan(inverse);
+    fftwf_free(time);
+    fftwf_free(spectrum);
+    fftwf_free(filtered);
+}
+
+bool ReverberationTime::write(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Failed to create " << path << std::endl;
+        return false;
+    }
+
+    file << "band_hz,edt_s,t20_s,t30_s\n" << std::fixed << std::setprecision(3);
+    for (const auto& band : bands) {
+        file << band.center << "," << band.edt << "," << band.t20 << "," << band.t30 << "\n";
+    }
+    return true;
+}
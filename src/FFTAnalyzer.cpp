@@ -1,35 +1,198 @@
 #include "FFTAnalyzer.h"
+#include "DspKernels.h"
 #include <cmath>
 #include <algorithm>
 #include <iostream>
 
-FFTAnalyzer::FFTAnalyzer(int fftSize, int sampleRate, int numBands, float minFreq, float maxFreq,
-                         float minDb, float maxDb, float noiseThreshold, bool freqWeighting, float smoothing)
-    : fftSize(fftSize), sampleRate(sampleRate), numBands(numBands),
-      minFreq(minFreq), maxFreq(maxFreq), minDb(minDb), maxDb(maxDb),
-      noiseThreshold(noiseThreshold), freqWeighting(freqWeighting), smoothing(smoothing) {
+FFTAnalyzer::FFTAnalyzer(const SpectrumConfig& config)
+    : fftSize(config.fftSize), sampleRate(config.sampleRate),
+      minFreq(config.minFreq), maxFreq(config.maxFreq), minDb(config.minDb), maxDb(config.maxDb),
+      noiseThreshold(config.noiseThreshold), aggregation(config.bandAggregation),
+      noiseFloorMode(config.noiseFloor),
+      noiseFloorMargin(std::pow(10.0f, config.noiseFloorMargin / 10.0f)) {
 
     inputBuffer.resize(fftSize, 0.0f);
-    windowFunction.resize(fftSize);
-    bands.resize(numBands, 0.0f);
-    peaks.resize(numBands, 0.0f);
-    smoothedBands.resize(numBands, 0.0f);
+    windowedBuffer.resize(fftSize, 0.0f);
+    window = WindowFunction::get(config, fftSize);
+    enbw = window->getEnbw();
 
-    // Hanning window
-    for (int i = 0; i < fftSize; ++i) {
-        windowFunction[i] = 0.5f * (1.0f - std::cos(2.0f * M_PI * i / (fftSize - 1)));
+    // Allocate FFTW buffers, the plan once it is known whether the stereo stage replaces it
+    fftOutput = fftwf_alloc_complex(fftSize / 2 + 1);
+
+    magnitudes.resize(fftSize / 2, 0.0f);
+    power.resize(fftSize / 2, 0.0f);
+    binStartFreq = 0.0f;
+    binWidth = static_cast<float>(sampleRate) / fftSize;
+
+    // Zoom in on narrow ranges instead of discarding most of a full-band FFT
+    if (config.zoomFFT) {
+        if (ZoomFFT::decimationFor(sampleRate, minFreq, maxFreq) >= 2) {
+            auto zoomWindow = WindowFunction::get(config, config.zoomFFTSize);
+            enbw = zoomWindow->getEnbw();
+            zoomFFT = std::make_unique<ZoomFFT>(sampleRate, minFreq, maxFreq, zoomWindow);
+            magnitudes.resize(config.zoomFFTSize, 0.0f);
+            power.resize(config.zoomFFTSize, 0.0f);
+            binStartFreq = zoomFFT->getStartFreq();
+            binWidth = zoomFFT->getBinWidth();
+        } else {
+            std::cout << "Zoom FFT: range " << minFreq << "-" << maxFreq
+                      << " Hz is too wide to zoom, using full-band FFT" << std::endl;
+        }
     }
 
-    // Allocate FFTW buffers
-    fftOutput = fftwf_alloc_complex(fftSize / 2 + 1);
-    fftPlan = fftwf_plan_dft_r2c_1d(fftSize, inputBuffer.data(), fftOutput, FFTW_MEASURE);
+    // Band edges and bin weights, shared with other analyzers on the same grid
+    layout = BandLayout::get(config, binStartFreq, binWidth, static_cast<int>(magnitudes.size()));
+    numBands = layout->getNumBands();
+    kernels = FrameKernels::create(window, layout, static_cast<int>(magnitudes.size()));
+
+    bandLevels.resize(numBands, 0.0f);
+
+    if (noiseFloorMode != NoiseFloorMode::Off) {
+        noiseFloor = std::make_unique<NoiseFloor>(numBands, config.noiseFloorWindow,
+                                                  std::pow(10.0f, config.noiseFloorMax / 10.0f));
+        bandPower.resize(numBands, 0.0f);
+    }
+
+    bandDb.resize(numBands, minDb);
+    if (config.autoRange) {
+        autoRange = std::make_unique<AutoRange>(config);
+    }
+
+    float hopSeconds = static_cast<float>(fftSize / 2) / sampleRate;
+    ballistics = std::make_unique<Ballistics>(numBands, Ballistics::fromConfig(config, hopSeconds), minDb);
+    snapshot.bands.resize(numBands, 0.0f);
+    snapshot.peaks.resize(numBands, 0.0f);
+    snapshot.minDb = minDb;
+    snapshot.maxDb = maxDb;
+
+    // Long-term averaged trace of the power spectrum, the trace set always has one
+    AveragingMode averaging = config.averaging;
+    if (config.traces && averaging == AveragingMode::Off) {
+        averaging = AveragingMode::Infinite;
+    }
+    if (averaging != AveragingMode::Off) {
+        averager = std::make_unique<SpectrumAverager>(averaging, static_cast<int>(power.size()),
+                                                      config.averageFrames, config.averageTime);
+        averageMagnitudes.resize(power.size(), 0.0f);
+        averageLevels.resize(numBands, minDb);
+    }
+
+    // Max/min hold and reference traces over the ballistics levels
+    if (config.traces) {
+        traces = std::make_unique<TraceSet>(numBands);
+    }
+
+    if (config.loudness) {
+        loudness = std::make_unique<LoudnessMeter>(sampleRate);
+    }
+    if (config.truePeak) {
+        truePeak = std::make_unique<TruePeakMeter>(config.truePeakOver);
+    }
+
+    // Feedback detection runs on the peak list even when it is not published
+    int peakCount = config.peakCount;
+    if (config.feedback) {
+        peakCount = std::max(peakCount, 8);
+    }
+    if (peakCount > 0) {
+        peakFinder = std::make_unique<PeakFinder>(peakCount,
+                                                  std::pow(10.0f, config.peakThreshold / 20.0f));
+        publishPeaks = config.peakCount > 0;
+    }
+    if (config.feedback) {
+        FeedbackDetector::Params params;
+        params.hops = config.feedbackHops;
+        params.minRatioDb = config.feedbackRatio;
+        params.minGrowth = config.feedbackGrowth;
+        feedback = std::make_unique<FeedbackDetector>(params, layout);
+    }
+
+    if (config.beats) {
+        float framePeriod = zoomFFT
+            ? static_cast<float>(config.zoomFFTSize / 2 * zoomFFT->getDecimation()) / sampleRate
+            : static_cast<float>(fftSize / 2) / sampleRate;
+        beats = std::make_unique<BeatTracker>(static_cast<int>(magnitudes.size()), framePeriod,
+                                              config.onsetSensitivity);
+    }
+
+    // Pitch needs the time-domain frame, chroma works on any bin grid
+    if (config.pitch) {
+        if (!zoomFFT) {
+            pitch = std::make_unique<PitchDetector>(fftSize, sampleRate, config.pitchMinFreq, config.pitchMaxFreq);
+        } else {
+            std::cout << "Pitch detection is not available with zoom FFT" << std::endl;
+        }
+    }
+    if (config.chroma) {
+        chroma = std::make_unique<Chromagram>(static_cast<int>(magnitudes.size()), binStartFreq, binWidth);
+    }
+
+    if (config.features) {
+        features = std::make_unique<SpectralFeatures>(static_cast<int>(power.size()), binStartFreq, binWidth,
+                                                      minFreq, maxFreq);
+    }
+
+    if (config.harmonics) {
+        if (!zoomFFT) {
+            harmonics = std::make_unique<HarmonicAnalyzer>(fftSize, sampleRate, config.harmonicMinFreq,
+                                                           config.harmonicMaxFreq, config.harmonicCount);
+            harmonicsShareSpectrum = config.window == WindowType::FlatTop;
+        } else {
+            std::cout << "Harmonic analysis is not available with zoom FFT" << std::endl;
+        }
+    }
+
+    // Stereo stage on the full-band grid
+    if (config.stereo) {
+        if (!zoomFFT) {
+            stereo = std::make_unique<StereoAnalyzer>(fftSize, sampleRate, window, layout);
+            leftBuffer.resize(fftSize, 0.0f);
+            rightBuffer.resize(fftSize, 0.0f);
+        } else {
+            std::cout << "Stereo analysis is not available with zoom FFT" << std::endl;
+        }
+    }
+    if (config.transfer) {
+        if (!zoomFFT) {
+            // Same rows without the frequency weighting, which would otherwise
+            // tilt the per-bin weights inside each band's mean response
+            SpectrumConfig flat = config;
+            flat.freqWeighting = FrequencyWeighting::Z;
+            auto flatLayout = BandLayout::get(flat, binStartFreq, binWidth, static_cast<int>(magnitudes.size()));
+            transfer = std::make_unique<TransferAnalyzer>(fftSize, sampleRate, window, flatLayout,
+                                                          config.transferReference,
+                                                          config.transferAverageTime,
+                                                          config.transferAutoDelay);
+        } else {
+            std::cout << "Transfer function is not available with zoom FFT" << std::endl;
+        }
+    }
+
+    // Chirp-Z evaluation at the band centers
+    if (config.cztBands && !zoomFFT) {
+        chirpZBands = std::make_unique<ChirpZBands>(fftSize, sampleRate, layout->getCenters(),
+                                                    window->getAmplitudeScale());
+    }
+
+    if (aggregation == BandAggregation::Reassigned) {
+        if (!zoomFFT) {
+            reassigned = std::make_unique<ReassignedSpectrum>(fftSize, sampleRate, fftSize / 2, window, layout,
+                                                              config.freqWeighting);
+        } else {
+            std::cout << "Reassigned bands are not available with zoom FFT, using power" << std::endl;
+        }
+    }
+
+    if (!stereo) {
+        fftPlan = fftwf_plan_dft_r2c_1d(fftSize, windowedBuffer.data(), fftOutput, FFTW_MEASURE);
+    }
 
     std::cout << "FFT Analyzer initialized: " << numBands << " bands, "
               << fftSize << " FFT size" << std::endl;
 }
 
 FFTAnalyzer::~FFTAnalyzer() {
-    fftwf_destroy_plan(fftPlan);
+    if (fftPlan) fftwf_destroy_plan(fftPlan);
     fftwf_free(fftOutput);
 }
 
@@ -39,14 +202,66 @@ void FFTAnalyzer::process(const float* samples, size_t count) {
     static int processCount = 0;
     static float maxSample = 0.0f;
 
-    // Convert stereo to mono and accumulate in buffer
-    for (size_t i = 0; i < count; i += 2) {
-        if (bufferPos < static_cast<size_t>(fftSize)) {
-            // Average left and right channels
-            float sample = (samples[i] + samples[i + 1]) * 0.5f;
-            inputBuffer[bufferPos++] = sample;
-            maxSample = std::max(maxSample, std::abs(sample));
+    size_t frames = count / 2;
+    if (loudness) {
+        loudness->process(samples, frames);
+    }
+    if (truePeak) {
+        truePeak->process(samples, frames);
+    }
+    if (transfer) {
+        transfer->process(samples, frames);
+    }
+
+    // Convert stereo to mono
+    monoBuffer.resize(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        // Average left and right channels
+        float sample = (samples[2 * i] + samples[2 * i + 1]) * 0.5f;
+        monoBuffer[i] = sample;
+        maxSample = std::max(maxSample, std::abs(sample));
+    }
+
+    if (zoomFFT) {
+        // One callback can complete several zoom frames; each is published
+        // with its own time so the beat tracker sees a steady frame rate
+        size_t offset = 0;
+        while (offset < frames) {
+            size_t consumed = 0;
+            bool ready = zoomFFT->process(monoBuffer.data() + offset, frames - offset, consumed);
+            offset += consumed;
+            samplesIngested += consumed;
+            if (!ready) break;
+
+            frameTime = static_cast<double>(samplesIngested) / sampleRate;
+            const auto& zoomMagnitudes = zoomFFT->getMagnitudes();
+            if (peakFinder) {
+                // Copy and peak scan in one pass
+                peakFinder->begin();
+                const int last = static_cast<int>(zoomMagnitudes.size()) - 1;
+                for (int bin = 0; bin <= last; ++bin) {
+                    magnitudes[bin] = zoomMagnitudes[bin];
+                    if (bin >= 2) peakFinder->offer(magnitudes.data(), bin - 1);
+                }
+                peakFinder->finish(magnitudes.data(), binStartFreq, binWidth);
+            } else {
+                magnitudes = zoomMagnitudes;
+            }
+            power = zoomFFT->getPower();
+            calculateBands();
+            publish();
+        }
+        return;
+    }
+
+    // Accumulate in buffer
+    for (size_t i = 0; i < frames; ++i) {
+        if (stereo) {
+            leftBuffer[bufferPos] = samples[2 * i];
+            rightBuffer[bufferPos] = samples[2 * i + 1];
         }
+        inputBuffer[bufferPos++] = monoBuffer[i];
+        ++samplesIngested;
 
         // When buffer is full, perform FFT
         if (bufferPos >= static_cast<size_t>(fftSize)) {
@@ -57,92 +272,186 @@ void FFTAnalyzer::process(const float* samples, size_t count) {
             }
 
             performFFT();
+            if (reassigned) {
+                reassigned->process(inputBuffer.data(), fftOutput, power.data());
+            }
+            if (chirpZBands) {
+                chirpZBands->process(windowedBuffer.data());
+            }
+            if (pitch) {
+                pitch->process(inputBuffer.data());
+            }
+            if (harmonics) {
+                if (harmonicsShareSpectrum) {
+                    harmonics->analyze(power.data());
+                } else {
+                    harmonics->process(inputBuffer.data());
+                }
+            }
+            frameTime = static_cast<double>(samplesIngested) / sampleRate;
             calculateBands();
+            publish();
 
             // Overlap: shift buffer by half
             std::copy(inputBuffer.begin() + fftSize / 2, inputBuffer.end(),
                      inputBuffer.begin());
+            if (stereo) {
+                std::copy(leftBuffer.begin() + fftSize / 2, leftBuffer.end(), leftBuffer.begin());
+                std::copy(rightBuffer.begin() + fftSize / 2, rightBuffer.end(), rightBuffer.begin());
+            }
             bufferPos = fftSize / 2;
         }
     }
 }
 
 void FFTAnalyzer::performFFT() {
-    // Apply window function
-    for (int i = 0; i < fftSize; ++i) {
-        inputBuffer[i] *= windowFunction[i];
+    if (stereo) {
+        // One complex FFT for both channels; its mid spectrum is the mono one
+        stereo->analyze(leftBuffer.data(), rightBuffer.data(), fftOutput);
+        if (chirpZBands) {
+            kernels->applyWindow(inputBuffer.data(), windowedBuffer.data());
+        }
+    } else {
+        // Apply window function (into a separate buffer so the overlap stays unwindowed)
+        kernels->applyWindow(inputBuffer.data(), windowedBuffer.data());
+
+        // Execute FFT
+        fftwf_execute(fftPlan);
     }
 
-    // Execute FFT
-    fftwf_execute(fftPlan);
+    // Window-corrected amplitude (1.0 = full-scale sine) and power per bin,
+    // with the peak scan in the same pass
+    PeakFinder* finder = peakFinder.get();
+    if (finder) finder->begin();
+    kernels->computeSpectrum(fftOutput, magnitudes.data(), power.data(), finder);
+    if (finder) finder->finish(magnitudes.data(), binStartFreq, binWidth);
 }
 
-void FFTAnalyzer::calculateBands() {
-    bands.assign(numBands, 0.0f);
+void FFTAnalyzer::aggregateBands(const float* mag, const float* pow, float* out) const {
+    const auto& spans = layout->getSpans();
+    const int lastBin = static_cast<int>(magnitudes.size()) - 1;
+
+    // Mode is fixed per layout, so each case is one tight loop over the rows.
+    // Frequency weighting is already in the layout weights; modes that pick a
+    // single value use the gain at the band center.
+    switch (aggregation) {
+        case BandAggregation::Mean:
+            kernels->applyMagnitude(mag, out);
+            for (int band = 0; band < numBands; ++band) {
+                float weight = layout->getRowWeight(band);
+                out[band] = weight > 0.0f ? out[band] / weight : 0.0f;
+            }
+            break;
+        case BandAggregation::Power:
+        case BandAggregation::Reassigned:  // Averages and zoom FFT have no phase to reassign
+            kernels->applyPower(pow, out);
+            for (int band = 0; band < numBands; ++band) {
+                out[band] = std::sqrt(out[band]);
+            }
+            break;
+        case BandAggregation::Max:
+            for (int band = 0; band < numBands; ++band) {
+                out[band] = dsp::maxValue(mag + spans[band].first, spans[band].count)
+                            * layout->getCenterGain(band);
+            }
+            break;
+        case BandAggregation::Interpolate:
+            kernels->applyPower(pow, out);
+            for (int band = 0; band < numBands; ++band) {
+                const auto& span = spans[band];
+                if (span.narrow && lastBin > 0) {
+                    // Narrower than a bin: read the spectrum at the band center
+                    float pos = std::clamp(span.centerBin, 0.0f, static_cast<float>(lastBin));
+                    int i0 = std::min(static_cast<int>(pos), lastBin - 1);
+                    float t = pos - i0;
+                    out[band] = (mag[i0] * (1.0f - t) + mag[i0 + 1] * t) * layout->getCenterGain(band);
+                } else {
+                    out[band] = std::sqrt(out[band]);
+                }
+            }
+            break;
+    }
+}
 
+void FFTAnalyzer::calculateBands() {
     static int calcCount = 0;
     static float maxBand = 0.0f;
 
-    // Logarithmic frequency distribution
-    float logMin = std::log10(minFreq);
-    float logMax = std::log10(maxFreq);
-    float logStep = (logMax - logMin) / numBands;
+    if (chirpZBands) {
+        // Spectrum evaluated exactly at the band centers
+        const auto& values = chirpZBands->getMagnitudes();
+        for (int band = 0; band < numBands; ++band) {
+            bandLevels[band] = values[band] * layout->getCenterGain(band);
+        }
+    } else if (reassigned) {
+        const auto& values = reassigned->getBandPower();
+        for (int band = 0; band < numBands; ++band) {
+            bandLevels[band] = std::sqrt(values[band]);
+        }
+    } else {
+        aggregateBands(magnitudes.data(), power.data(), bandLevels.data());
+    }
 
-    for (int band = 0; band < numBands; ++band) {
-        float freqLow = std::pow(10.0f, logMin + band * logStep);
-        float freqHigh = std::pow(10.0f, logMin + (band + 1) * logStep);
+    // Ballistics, averaging and the noise floor run on audio time between frames
+    float dt = static_cast<float>(frameTime - lastFrameTime);
+    lastFrameTime = frameTime;
 
-        int binLow = freqToFFTBin(freqLow);
-        int binHigh = freqToFFTBin(freqHigh);
+    if (feedback) {
+        feedback->update(peakFinder->getPeaks(), magnitudes.data(), static_cast<int>(magnitudes.size()),
+                         binStartFreq, binWidth, frameTime, dt);
+    }
 
-        // Average magnitude in this frequency range
-        float sum = 0.0f;
-        int count = 0;
+    if (beats) {
+        beats->update(magnitudes.data(), frameTime);
+    }
+    if (chroma) {
+        chroma->process(power.data());
+    }
+    if (features) {
+        features->process(power.data(), magnitudes.data(), frameTime);
+    }
 
-        for (int bin = binLow; bin <= binHigh && bin < fftSize / 2; ++bin) {
-            float real = fftOutput[bin][0];
-            float imag = fftOutput[bin][1];
-            float magnitude = std::sqrt(real * real + imag * imag);
-            sum += magnitude;
-            count++;
+    // Range from the levels before any gating
+    if (autoRange) {
+        for (int band = 0; band < numBands; ++band) {
+            bandDb[band] = toDb(bandLevels[band]);
         }
+        autoRange->update(bandDb.data(), numBands, dt);
+        minDb = autoRange->getMinDb();
+        maxDb = autoRange->getMaxDb();
+    }
 
-        if (count > 0) {
-            float average = sum / count;
+    if (noiseFloor) {
+        applyNoiseFloor(dt);
+    }
 
-            // Normalize by FFT size
-            average = average / (fftSize * 0.5f);
+    // Ballistics, holds and the average stay in dB; only publish() maps to
+    // the current display range. Levels below the display bottom are held
+    // there, as the 0-1 mapping did, so releases do not run off to -180 dB.
+    const float gateDb = minDb + noiseThreshold * (maxDb - minDb);
+    for (int band = 0; band < numBands; ++band) {
+        float db = toDb(bandLevels[band]);
 
-            // Apply frequency weighting (boost high frequencies)
-            if (freqWeighting) {
-                float centerFreq = std::sqrt(freqLow * freqHigh);
-                float weight = getFrequencyWeight(centerFreq);
-                average *= weight;
-            }
+        // Fixed noise gate when the floor is not tracked
+        if (!noiseFloor && db < gateDb) {
+            db = minDb;
+        }
 
-            // Apply sensitivity/gain and convert to dB
-            const float sensitivity = 2.0f;
-            float db = 20.0f * std::log10(average * sensitivity + 1e-9f);
+        bandDb[band] = std::max(db, minDb);
+    }
 
-            // Map dB range to 0-1 using config values
-            float dbRange = maxDb - minDb;
-            float normalized = std::max(0.0f, (db - minDb) / dbRange);
-            normalized = std::min(1.0f, normalized);
+    ballistics->update(bandDb.data(), dt);
 
-            // Apply noise gate
-            if (normalized < noiseThreshold) {
-                normalized = 0.0f;
-            }
+    if (averager) {
+        calculateAverage(dt);
+    }
 
-            bands[band] = normalized;
-        }
+    if (traces) {
+        traces->update(ballistics->getLevels().data());
     }
 
-    // Smooth bands (use config value)
-    for (int i = 0; i < numBands; ++i) {
-        smoothedBands[i] = smoothedBands[i] * smoothing + bands[i] * (1.0f - smoothing);
-        bands[i] = smoothedBands[i];
-        maxBand = std::max(maxBand, bands[i]);
+    for (float level : ballistics->getLevels()) {
+        maxBand = std::max(maxBand, dbToDisplay(level));
     }
 
     if (++calcCount % 10 == 0) {
@@ -152,33 +461,214 @@ void FFTAnalyzer::calculateBands() {
     }
 }
 
-void FFTAnalyzer::updatePeaks(float decayAmount) {
-    std::lock_guard<std::mutex> lock(mutex);
+void FFTAnalyzer::calculateAverage(float dt) {
+    averager->update(power.data(), dt);
+    if (averager->isFrozen()) return;
 
-    for (int i = 0; i < numBands; ++i) {
-        if (bands[i] > peaks[i]) {
-            peaks[i] = bands[i];
-        } else {
-            // Linear decay - constant fall rate
-            peaks[i] -= decayAmount;
-            if (peaks[i] < 0.0f) peaks[i] = 0.0f;
+    // Averaged power back to amplitude units so every aggregation mode works on it
+    const auto& avgPower = averager->getAverage();
+    for (size_t bin = 0; bin < avgPower.size(); ++bin) {
+        averageMagnitudes[bin] = std::sqrt(avgPower[bin] * enbw);
+    }
+
+    aggregateBands(averageMagnitudes.data(), avgPower.data(), averageLevels.data());
+    for (int band = 0; band < numBands; ++band) {
+        averageLevels[band] = toDb(averageLevels[band]);
+    }
+}
+
+void FFTAnalyzer::applyNoiseFloor(float dt) {
+    for (int band = 0; band < numBands; ++band) {
+        bandPower[band] = bandLevels[band] * bandLevels[band];
+    }
+    noiseFloor->update(bandPower.data(), dt);
+
+    const auto& floor = noiseFloor->getFloor();
+    if (noiseFloorMode == NoiseFloorMode::Gate) {
+        for (int band = 0; band < numBands; ++band) {
+            if (bandPower[band] < floor[band] * noiseFloorMargin) bandLevels[band] = 0.0f;
+        }
+    } else {
+        for (int band = 0; band < numBands; ++band) {
+            bandLevels[band] = std::sqrt(std::max(bandPower[band] - floor[band], 0.0f));
         }
     }
 }
 
-int FFTAnalyzer::freqToFFTBin(float freq) const {
-    return static_cast<int>(freq * fftSize / sampleRate);
+float FFTAnalyzer::toDb(float level) {
+    // dBFS, the window gain is already corrected
+    return 20.0f * std::log10(level + 1e-9f);
 }
 
-float FFTAnalyzer::getFrequencyWeight(float freq) const {
-    // Simplified A-weighting style curve
-    // Boosts high frequencies to compensate for natural rolloff
-    if (freq < 1000.0f) {
-        // Low frequencies: gradual boost from 20Hz to 1kHz
-        return 1.0f + (freq - 20.0f) / 1000.0f * 0.5f;
-    } else {
-        // High frequencies: significant boost above 1kHz
-        float octaves = std::log2(freq / 1000.0f);
-        return 1.5f + octaves * 0.8f; // +0.8x per octave above 1kHz
+float FFTAnalyzer::dbToDisplay(float db) const {
+    // Map the current dB range to 0-1
+    float dbRange = maxDb - minDb;
+    float normalized = std::max(0.0f, (db - minDb) / dbRange);
+    return std::min(1.0f, normalized);
+}
+
+void FFTAnalyzer::dbToDisplay(const std::vector<float>& db, std::vector<float>& out) const {
+    out.resize(db.size());
+    for (size_t i = 0; i < db.size(); ++i) {
+        out[i] = dbToDisplay(db[i]);
     }
 }
+
+void FFTAnalyzer::resetAverage() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (averager) {
+        averager->reset();
+        std::fill(averageLevels.begin(), averageLevels.end(), minDb);
+    }
+}
+
+void FFTAnalyzer::setAverageFrozen(bool frozen) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (averager) averager->setFrozen(frozen);
+}
+
+bool FFTAnalyzer::isAverageFrozen() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return averager && averager->isFrozen();
+}
+
+void FFTAnalyzer::resetLoudness() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (loudness) loudness->reset();
+    if (truePeak) truePeak->reset();
+}
+
+bool FFTAnalyzer::popFeedbackEvent(FeedbackEvent& event) {
+    // The queue is lock-free, no mutex
+    return feedback && feedback->popEvent(event);
+}
+
+bool FFTAnalyzer::popFeatureFrame(SpectralFeatureFrame& frame) {
+    return features && features->popFrame(frame);
+}
+
+void FFTAnalyzer::resetTransfer() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (transfer) transfer->reset();
+}
+
+void FFTAnalyzer::resetHolds() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (traces) traces->resetHolds();
+}
+
+void FFTAnalyzer::captureReference() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!traces) return;
+
+    // The long-term average is the steadier curve to compare against
+    traces->captureReference(averager ? averageLevels : ballistics->getLevels());
+    dbToDisplay(traces->getReference(), snapshot.reference);
+}
+
+void FFTAnalyzer::clearReference() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!traces) return;
+
+    traces->clearReference();
+    snapshot.reference.clear();
+}
+
+void FFTAnalyzer::publish() {
+    // Caller holds the mutex
+    snapshot.frame = ++frameCount;
+    snapshot.timestamp = frameTime;
+    snapshot.minDb = minDb;
+    snapshot.maxDb = maxDb;
+    dbToDisplay(ballistics->getLevels(), snapshot.bands);
+    dbToDisplay(ballistics->getPeaks(), snapshot.peaks);
+
+    if (averager) {
+        dbToDisplay(averageLevels, snapshot.average);
+        snapshot.averageFrames = averager->getFrameCount();
+        snapshot.averageFrozen = averager->isFrozen();
+    }
+
+    if (loudness) {
+        snapshot.momentaryLoudness = loudness->getMomentary();
+        snapshot.shortTermLoudness = loudness->getShortTerm();
+        snapshot.integratedLoudness = loudness->getIntegrated();
+        snapshot.loudnessRange = loudness->getRange();
+    }
+
+    if (truePeak) {
+        auto toDb = [](float peak) { return 20.0f * std::log10(peak + 1e-9f); };
+        for (int ch = 0; ch < TruePeakMeter::kChannels; ++ch) {
+            snapshot.truePeak[ch] = toDb(truePeak->getBlockPeak(ch));
+            snapshot.maxTruePeak[ch] = toDb(truePeak->getMaxPeak(ch));
+            snapshot.truePeakOvers[ch] = truePeak->getOvers(ch);
+        }
+        truePeak->startBlock();
+    }
+
+    if (stereo) {
+        snapshot.correlation = stereo->getCorrelation();
+        snapshot.balance = stereo->getBalance();
+        snapshot.mid.resize(numBands);
+        snapshot.side.resize(numBands);
+        for (int band = 0; band < numBands; ++band) {
+            snapshot.mid[band] = dbToDisplay(toDb(stereo->getMid()[band]));
+            snapshot.side[band] = dbToDisplay(toDb(stereo->getSide()[band]));
+        }
+    }
+
+    if (transfer) {
+        snapshot.transferDb = transfer->getMagnitudeDb();
+        snapshot.transferPhase = transfer->getPhase();
+        snapshot.coherence = transfer->getCoherence();
+        snapshot.transferDelay = transfer->getDelay();
+    }
+
+    if (publishPeaks) {
+        const auto& found = peakFinder->getPeaks();
+        snapshot.spectralPeaks.resize(found.size());
+        for (size_t i = 0; i < found.size(); ++i) {
+            snapshot.spectralPeaks[i].frequency = found[i].frequency;
+            snapshot.spectralPeaks[i].levelDb = 20.0f * std::log10(found[i].magnitude);
+        }
+    }
+
+    if (beats) {
+        snapshot.onsetCount = beats->getOnsetCount();
+        snapshot.onsetTime = beats->getOnsetTime();
+        snapshot.onsetStrength = beats->getOnsetStrength();
+        snapshot.tempo = beats->getTempo();
+        snapshot.tempoTime = beats->getTempoTime();
+    }
+
+    if (pitch) {
+        snapshot.pitch = pitch->getPitch();
+        snapshot.pitchConfidence = pitch->getConfidence();
+    }
+    if (chroma) {
+        snapshot.chroma = chroma->getChroma();
+    }
+    if (features) {
+        snapshot.features = features->getFrame();
+    }
+    if (harmonics) {
+        snapshot.fundamental = harmonics->getFundamental();
+        snapshot.fundamentalDb = harmonics->getFundamentalDb();
+        snapshot.harmonicsDb = harmonics->getHarmonicsDb();
+        snapshot.thd = harmonics->getThd();
+        snapshot.thdN = harmonics->getThdN();
+        snapshot.harmonicsResolved = harmonics->isResolved();
+    }
+
+    // Traces follow the live range, so they are remapped every frame
+    if (traces) {
+        dbToDisplay(traces->getMaxHold(), snapshot.maxHold);
+        dbToDisplay(traces->getMinHold(), snapshot.minHold);
+        dbToDisplay(traces->getReference(), snapshot.reference);
+    }
+}
+
+void FFTAnalyzer::getSnapshot(SpectrumSnapshot& out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    out = snapshot;
+}
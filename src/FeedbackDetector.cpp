@@ -0,0 +1,123 @@
+#include "FeedbackDetector.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    // A peak continues a track within this distance, in bins
+    constexpr float kMatchBins = 1.0f;
+
+    // Feedback holds its frequency; tones that move more per hop are music
+    constexpr float kMaxDriftBins = 0.1f;
+
+    // Neighbourhood for the peak ratio, skipping the main lobe
+    constexpr int kLobeBins = 3;
+    constexpr int kNeighbourBins = 12;
+
+    // Per-hop smoothing of the growth rate and frequency drift
+    constexpr float kSmoothing = 0.3f;
+}
+
+FeedbackDetector::FeedbackDetector(const Params& params, std::shared_ptr<const BandLayout> layout)
+    : params(params), layout(std::move(layout)) {
+}
+
+void FeedbackDetector::update(const std::vector<PeakFinder::Peak>& peaks, const float* mag, int numBins,
+                              float binStartFreq, float binWidth, double time, float dt) {
+    matched.fill(false);
+
+    for (const auto& peak : peaks) {
+        float levelDb = 20.0f * std::log10(peak.magnitude + 1e-12f);
+
+        // Closest active track, or a free slot
+        int best = -1;
+        float bestDistance = kMatchBins;
+        int freeSlot = -1;
+        for (int t = 0; t < kMaxTracks; ++t) {
+            const Track& track = tracks[t];
+            if (!track.active) {
+                if (freeSlot < 0) freeSlot = t;
+                continue;
+            }
+            float distance = std::fabs(peak.frequency - track.frequency) / binWidth;
+            if (!matched[t] && distance <= bestDistance) {
+                best = t;
+                bestDistance = distance;
+            }
+        }
+
+        if (best < 0) {
+            if (freeSlot < 0) continue;  // Tracks full, keep the established ones
+            Track& track = tracks[freeSlot];
+            track = Track{};
+            track.active = true;
+            track.frequency = peak.frequency;
+            track.levelDb = levelDb;
+            track.hits = 1;
+            matched[freeSlot] = true;
+            continue;
+        }
+
+        Track& track = tracks[best];
+        matched[best] = true;
+        track.drift += (bestDistance - track.drift) * kSmoothing;
+        if (dt > 0.0f) {
+            float rate = (levelDb - track.levelDb) / dt;
+            track.growth += (rate - track.growth) * kSmoothing;
+        }
+        track.frequency = peak.frequency;
+        track.levelDb = levelDb;
+        track.misses = 0;
+        ++track.hits;
+
+        if (track.reported || track.hits < params.hops || track.drift > kMaxDriftBins ||
+            track.growth < params.minGrowth) {
+            continue;
+        }
+
+        int bin = static_cast<int>(std::lround((peak.frequency - binStartFreq) / binWidth));
+        float ratioDb = neighbourhoodRatioDb(mag, numBins, bin, peak.magnitude);
+        if (ratioDb < params.minRatioDb) continue;
+
+        FeedbackEvent event;
+        event.frequency = track.frequency;
+        event.levelDb = levelDb;
+        event.ratioDb = ratioDb;
+        event.growth = track.growth;
+        event.band = bandOf(track.frequency);
+        event.timestamp = time;
+        track.reported = events.push(event);
+    }
+
+    // Tracks without a peak this frame fade out after a few misses
+    for (int t = 0; t < kMaxTracks; ++t) {
+        if (tracks[t].active && !matched[t] && ++tracks[t].misses > kMaxMisses) {
+            tracks[t].active = false;
+        }
+    }
+}
+
+float FeedbackDetector::neighbourhoodRatioDb(const float* mag, int numBins, int bin, float peak) const {
+    float sum = 0.0f;
+    int count = 0;
+    for (int offset = kLobeBins; offset <= kNeighbourBins; ++offset) {
+        if (bin - offset >= 0) {
+            sum += mag[bin - offset];
+            ++count;
+        }
+        if (bin + offset < numBins) {
+            sum += mag[bin + offset];
+            ++count;
+        }
+    }
+    float mean = count > 0 ? sum / count : 0.0f;
+    return 20.0f * std::log10((peak + 1e-12f) / (mean + 1e-12f));
+}
+
+int FeedbackDetector::bandOf(float frequency) const {
+    const auto& low = layout->getLow();
+    const auto& high = layout->getHigh();
+    auto it = std::upper_bound(low.begin(), low.end(), frequency);
+    if (it == low.begin()) return -1;
+    int band = static_cast<int>(it - low.begin()) - 1;
+    return frequency < high[band] ? band : -1;
+}
@@ -0,0 +1,66 @@
+#include "FrameKernels.h"
+#include "FixedFrameKernels.h"
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+std::unique_ptr<FrameKernels> FrameKernels::create(std::shared_ptr<const WindowFunction> window,
+                                                   std::shared_ptr<const BandLayout> layout, int numBins) {
+    std::unique_ptr<FrameKernels> kernels;
+
+    // Deployed FFT size / band count pairs
+    if (FixedFrameKernels<4096, 64>::matches(*window, *layout, numBins)) {
+        kernels = std::make_unique<FixedFrameKernels<4096, 64>>(window, *layout);
+    } else if (FixedFrameKernels<8192, 128>::matches(*window, *layout, numBins)) {
+        kernels = std::make_unique<FixedFrameKernels<8192, 128>>(window, *layout);
+    } else if (FixedFrameKernels<16384, 256>::matches(*window, *layout, numBins)) {
+        kernels = std::make_unique<FixedFrameKernels<16384, 256>>(window, *layout);
+    } else {
+        kernels = std::make_unique<GenericFrameKernels>(window, layout);
+    }
+
+    std::cout << "Frame kernels: " << kernels->getName() << std::endl;
+    return kernels;
+}
+
+GenericFrameKernels::GenericFrameKernels(std::shared_ptr<const WindowFunction> window,
+                                         std::shared_ptr<const BandLayout> layout)
+    : window(std::move(window)), layout(std::move(layout)) {
+    fftSize = this->window->size();
+    amplitudeScale = this->window->getAmplitudeScale();
+    powerScale = this->window->getPowerScale();
+}
+
+void GenericFrameKernels::applyWindow(const float* input, float* out) const {
+    const float* w = window->data();
+    for (int i = 0; i < fftSize; ++i) {
+        out[i] = input[i] * w[i];
+    }
+}
+
+void GenericFrameKernels::computeSpectrum(const fftwf_complex* spectrum, float* magnitudes, float* power,
+                                          PeakFinder* finder) const {
+    const int numBins = fftSize / 2;
+    const int chunk = finder ? kSpectrumChunk : numBins;
+    for (int first = 0; first < numBins; first += chunk) {
+        const int end = std::min(first + chunk, numBins);
+        for (int bin = first; bin < end; ++bin) {
+            float real = spectrum[bin][0];
+            float imag = spectrum[bin][1];
+            float squared = real * real + imag * imag;
+            power[bin] = squared * powerScale;
+            magnitudes[bin] = std::sqrt(squared) * amplitudeScale;
+        }
+
+        // Previous bin has both neighbours once a bin is written
+        if (finder) finder->offerRange(magnitudes, std::max(first - 1, 1), end - 1);
+    }
+}
+
+void GenericFrameKernels::applyPower(const float* power, float* out) const {
+    layout->applyPower(power, out);
+}
+
+void GenericFrameKernels::applyMagnitude(const float* magnitudes, float* out) const {
+    layout->applyMagnitude(magnitudes, out);
+}
@@ -0,0 +1,53 @@
+#include "FrequencyWeighting.h"
+#include <cmath>
+
+namespace {
+    // IEC 61672-1 pole frequencies
+    constexpr double f1 = 20.598997;
+    constexpr double f2 = 107.65265;
+    constexpr double f3 = 737.86223;
+    constexpr double f4 = 12194.217;
+    constexpr double f5 = 158.48932;
+
+    double weightA(double f) {
+        double f2sq = f * f;
+        double r = (f4 * f4 * f2sq * f2sq) /
+                   ((f2sq + f1 * f1) * std::sqrt((f2sq + f2 * f2) * (f2sq + f3 * f3)) * (f2sq + f4 * f4));
+        return r * std::pow(10.0, 2.0 / 20.0);
+    }
+
+    double weightB(double f) {
+        double f2sq = f * f;
+        double r = (f4 * f4 * f2sq * f) /
+                   ((f2sq + f1 * f1) * std::sqrt(f2sq + f5 * f5) * (f2sq + f4 * f4));
+        return r * std::pow(10.0, 0.17 / 20.0);
+    }
+
+    double weightC(double f) {
+        double f2sq = f * f;
+        double r = (f4 * f4 * f2sq) / ((f2sq + f1 * f1) * (f2sq + f4 * f4));
+        return r * std::pow(10.0, 0.06 / 20.0);
+    }
+
+    double weightItu468(double f) {
+        double h1 = -4.737338981378384e-24 * std::pow(f, 6) + 2.043828333606125e-15 * std::pow(f, 4)
+                    - 1.363894795463638e-07 * f * f + 1.0;
+        double h2 = 1.306612257412824e-19 * std::pow(f, 5) - 2.118150887518656e-11 * std::pow(f, 3)
+                    + 5.559488023498642e-04 * f;
+        double r = 1.246332637532143e-04 * f / std::sqrt(h1 * h1 + h2 * h2);
+        return r * std::pow(10.0, 18.2 / 20.0);
+    }
+}
+
+float frequencyWeightGain(FrequencyWeighting weighting, float freq) {
+    double f = std::fabs(static_cast<double>(freq));
+
+    switch (weighting) {
+        case FrequencyWeighting::A: return static_cast<float>(weightA(f));
+        case FrequencyWeighting::B: return static_cast<float>(weightB(f));
+        case FrequencyWeighting::C: return static_cast<float>(weightC(f));
+        case FrequencyWeighting::Itu468: return static_cast<float>(weightItu468(f));
+        case FrequencyWeighting::Z: break;
+    }
+    return 1.0f;
+}
@@ -0,0 +1,130 @@
+#include "HarmonicAnalyzer.h"
+#include "DspKernels.h"
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // The 5-term flat-top main lobe is 10 bins wide
+    constexpr int kFlatTopHalfWidth = 5;
+
+    // THD+N measurement bandwidth
+    constexpr float kBandLow = 20.0f;
+    constexpr float kBandHigh = 20000.0f;
+
+    // Below this the frame is silence and nothing is locked
+    constexpr float kMinPower = 1e-12f;
+}
+
+HarmonicAnalyzer::HarmonicAnalyzer(int frameSize, int sampleRate, float minFreq, float maxFreq,
+                                   int numHarmonics)
+    : frameSize(frameSize), numBins(frameSize / 2), numHarmonics(std::max(2, numHarmonics)) {
+    binWidth = static_cast<float>(sampleRate) / frameSize;
+    window = WindowFunction::get(WindowType::FlatTop, frameSize, 0.0f);
+
+    // Harmonic lobes overlap below 2 * kFlatTopHalfWidth bins of spacing
+    int minBin = static_cast<int>(std::ceil(minFreq / binWidth));
+    if (minBin < 2 * kFlatTopHalfWidth) {
+        std::cout << "Harmonics: " << minFreq << " Hz is only " << minBin
+                  << " bins, raise fft_size for accurate levels" << std::endl;
+    }
+
+    searchFirst = std::max(minBin, kFlatTopHalfWidth + 1);
+    searchLast = std::min(static_cast<int>(maxFreq / binWidth), numBins - kFlatTopHalfWidth - 1);
+
+    int bandFirst = std::max(static_cast<int>(std::ceil(kBandLow / binWidth)), kFlatTopHalfWidth + 1);
+    int bandLast = std::min(static_cast<int>(kBandHigh / binWidth), numBins - 1);
+    band = {bandFirst, std::max(0, bandLast - bandFirst + 1)};
+
+    timeBuffer = fftwf_alloc_real(frameSize);
+    spectrum = fftwf_alloc_complex(frameSize / 2 + 1);
+    plan = fftwf_plan_dft_r2c_1d(frameSize, timeBuffer, spectrum, FFTW_MEASURE);
+    power.resize(numBins, 0.0f);
+    harmonicsDb.resize(this->numHarmonics - 1, -std::numeric_limits<float>::infinity());
+}
+
+HarmonicAnalyzer::~HarmonicAnalyzer() {
+    fftwf_destroy_plan(plan);
+    fftwf_free(timeBuffer);
+    fftwf_free(spectrum);
+}
+
+void HarmonicAnalyzer::process(const float* frame) {
+    const float* w = window->data();
+    for (int i = 0; i < frameSize; ++i) timeBuffer[i] = frame[i] * w[i];
+    fftwf_execute(plan);
+
+    const float powerScale = window->getPowerScale();
+    for (int bin = 0; bin < numBins; ++bin) {
+        power[bin] = (spectrum[bin][0] * spectrum[bin][0] + spectrum[bin][1] * spectrum[bin][1]) * powerScale;
+    }
+    analyze(power.data());
+}
+
+void HarmonicAnalyzer::lockHarmonics(float fundamentalBins) {
+    lockedBins = fundamentalBins;
+    harmonicSpans.clear();
+    for (int n = 1; n <= numHarmonics; ++n) {
+        int center = static_cast<int>(std::lround(n * fundamentalBins));
+        if (center + kFlatTopHalfWidth >= numBins) break;
+        harmonicSpans.push_back({center - kFlatTopHalfWidth, 2 * kFlatTopHalfWidth + 1});
+    }
+
+    // Always the whole lobe; closer harmonics would share bins
+    bool wasResolved = resolved;
+    resolved = fundamentalBins >= 2 * kFlatTopHalfWidth + 1;
+    if (!resolved && wasResolved) {
+        std::cout << "Harmonics: " << fundamentalBins * binWidth << " Hz is only " << fundamentalBins
+                  << " bins, harmonic lobes overlap; raise fft_size" << std::endl;
+    }
+}
+
+float HarmonicAnalyzer::spanPower(const float* power, const Span& span) const {
+    return dsp::sum(power + span.first, span.count);
+}
+
+void HarmonicAnalyzer::analyze(const float* power) {
+    // Per-bin powers of a tone sum to A^2 over its main lobe
+    fundamental = 0.0f;
+    fundamentalDb = -std::numeric_limits<float>::infinity();
+    std::fill(harmonicsDb.begin(), harmonicsDb.end(), -std::numeric_limits<float>::infinity());
+    thd = 0.0f;
+    thdN = 0.0f;
+    if (searchLast < searchFirst) return;
+
+    int peakBin = static_cast<int>(std::max_element(power + searchFirst, power + searchLast + 1) - power);
+    if (power[peakBin] < kMinPower) return;
+
+    // Power centroid over the main lobe. It is biased by a small fraction
+    // of a bin depending on the offset, which only moves the harmonic
+    // centers; each harmonic is still summed over its whole lobe.
+    float sum = 0.0f;
+    float moment = 0.0f;
+    for (int k = -kFlatTopHalfWidth; k <= kFlatTopHalfWidth; ++k) {
+        sum += power[peakBin + k];
+        moment += k * power[peakBin + k];
+    }
+    float fundamentalBins = peakBin + moment / sum;
+    fundamental = fundamentalBins * binWidth;
+
+    // Harmonics are centered on multiples of the refined fundamental
+    if (std::fabs(fundamentalBins - lockedBins) * numHarmonics > 0.5f) {
+        lockHarmonics(fundamentalBins);
+    }
+
+    float fundamentalPower = spanPower(power, harmonicSpans[0]);
+    fundamentalDb = 10.0f * std::log10(fundamentalPower);
+    if (!resolved) return;
+
+    float harmonicPower = 0.0f;
+    for (size_t n = 1; n < harmonicSpans.size(); ++n) {
+        float p = spanPower(power, harmonicSpans[n]);
+        harmonicPower += p;
+        harmonicsDb[n - 1] = 10.0f * std::log10(p / fundamentalPower + 1e-20f);
+    }
+    thd = std::sqrt(harmonicPower / fundamentalPower);
+
+    float total = dsp::sum(power + band.first, band.count);
+    float residual = std::max(0.0f, total - fundamentalPower);
+    thdN = total > 0.0f ? std::sqrt(residual / total) : 0.0f;
+}
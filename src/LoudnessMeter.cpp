@@ -0,0 +1,208 @@
+#include "LoudnessMeter.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace {
+    // Histogram of block loudness: 0.1 LU bins from the absolute gate up
+    constexpr double kHistogramMin = -70.0;
+    constexpr double kHistogramStep = 0.1;
+    constexpr int kHistogramBins = 1000;
+
+    constexpr float kSilence = -std::numeric_limits<float>::infinity();
+
+    double loudnessOf(double meanSquare) {
+        return -0.691 + 10.0 * std::log10(meanSquare);
+    }
+
+    double meanSquareOf(double loudness) {
+        return std::pow(10.0, (loudness + 0.691) / 10.0);
+    }
+
+    double binCenter(int bin) {
+        return kHistogramMin + (bin + 0.5) * kHistogramStep;
+    }
+
+    // Below the absolute gate
+    int binOf(double loudness) {
+        if (loudness < kHistogramMin) return -1;
+        return std::min(static_cast<int>((loudness - kHistogramMin) / kHistogramStep), kHistogramBins - 1);
+    }
+
+    // First bin whose center is at or above the gate
+    int firstBinAbove(double gate) {
+        return std::clamp(static_cast<int>(std::ceil((gate - kHistogramMin) / kHistogramStep - 0.5)),
+                          0, kHistogramBins);
+    }
+
+    // Mean square at each bin center, shared by both histograms
+    const std::vector<double>& binMeanSquares() {
+        static const std::vector<double> table = [] {
+            std::vector<double> values(kHistogramBins);
+            for (int bin = 0; bin < kHistogramBins; ++bin) values[bin] = meanSquareOf(binCenter(bin));
+            return values;
+        }();
+        return table;
+    }
+}
+
+LoudnessMeter::LoudnessMeter(int sampleRate)
+    : blockSize(sampleRate / 10) {
+
+    // K-weighting for any sample rate, BS.1770 pre-filter and RLB high-pass
+    // re-derived from their analog prototypes
+    const double fs = sampleRate;
+    {
+        const double f0 = 1681.974450955533;
+        const double gain = 3.999843853973347;
+        const double q = 0.7071752369554196;
+        const double k = std::tan(M_PI * f0 / fs);
+        const double vh = std::pow(10.0, gain / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        shelf = {(vh + vb * k / q + k * k) / a0,
+                 2.0 * (k * k - vh) / a0,
+                 (vh - vb * k / q + k * k) / a0,
+                 2.0 * (k * k - 1.0) / a0,
+                 (1.0 - k / q + k * k) / a0};
+    }
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+        const double k = std::tan(M_PI * f0 / fs);
+        const double a0 = 1.0 + k / q + k * k;
+        highPass = {1.0, -2.0, 1.0,
+                    2.0 * (k * k - 1.0) / a0,
+                    (1.0 - k / q + k * k) / a0};
+    }
+
+    momentaryHistogram.resize(kHistogramBins, 0);
+    shortTermHistogram.resize(kHistogramBins, 0);
+    reset();
+}
+
+void LoudnessMeter::reset() {
+    for (auto& channel : state) {
+        for (auto& stage : channel) stage = FilterState{};
+    }
+    blockPos = 0;
+    blockSum = 0.0;
+    blocks.fill(0.0);
+    blockIndex = 0;
+    blocksFilled = 0;
+    std::fill(momentaryHistogram.begin(), momentaryHistogram.end(), 0);
+    std::fill(shortTermHistogram.begin(), shortTermHistogram.end(), 0);
+
+    momentary = kSilence;
+    shortTerm = kSilence;
+    integrated = kSilence;
+    range = 0.0f;
+}
+
+void LoudnessMeter::process(const float* samples, size_t frames) {
+    auto run = [](const Biquad& f, FilterState& s, double x) {
+        double y = f.b0 * x + s.z1;
+        s.z1 = f.b1 * x - f.a1 * y + s.z2;
+        s.z2 = f.b2 * x - f.a2 * y;
+        return y;
+    };
+
+    for (size_t i = 0; i < frames; ++i) {
+        // Channel weights are 1.0 for left and right
+        for (int ch = 0; ch < kChannels; ++ch) {
+            double y = run(shelf, state[ch][0], samples[kChannels * i + ch]);
+            y = run(highPass, state[ch][1], y);
+            blockSum += y * y;
+        }
+
+        if (++blockPos >= blockSize) {
+            endBlock();
+        }
+    }
+}
+
+void LoudnessMeter::endBlock() {
+    blocks[blockIndex] = blockSum / blockSize;
+    blockIndex = (blockIndex + 1) % kShortTermBlocks;
+    blocksFilled = std::min(blocksFilled + 1, kShortTermBlocks);
+    blockPos = 0;
+    blockSum = 0.0;
+
+    // Mean square of the last n blocks, newest first
+    auto windowMean = [this](int n) {
+        double sum = 0.0;
+        for (int j = 1; j <= n; ++j) {
+            sum += blocks[(blockIndex - j + kShortTermBlocks) % kShortTermBlocks];
+        }
+        return sum / n;
+    };
+
+    // Gating blocks overlap by 75%, one ends every 100 ms
+    if (blocksFilled >= kMomentaryBlocks) {
+        double value = loudnessOf(windowMean(kMomentaryBlocks));
+        momentary = static_cast<float>(value);
+        int bin = binOf(value);
+        if (bin >= 0) ++momentaryHistogram[bin];
+        updateIntegrated();
+    }
+
+    if (blocksFilled >= kShortTermBlocks) {
+        double value = loudnessOf(windowMean(kShortTermBlocks));
+        shortTerm = static_cast<float>(value);
+        int bin = binOf(value);
+        if (bin >= 0) ++shortTermHistogram[bin];
+        updateRange();
+    }
+}
+
+void LoudnessMeter::updateIntegrated() {
+    const auto& binPower = binMeanSquares();
+
+    // Blocks above the absolute gate are the ones in the histogram
+    double sum = 0.0;
+    uint64_t count = 0;
+    for (int bin = 0; bin < kHistogramBins; ++bin) {
+        sum += momentaryHistogram[bin] * binPower[bin];
+        count += momentaryHistogram[bin];
+    }
+    if (count == 0) return;
+
+    // Relative gate 10 LU below the absolute-gated loudness
+    int first = firstBinAbove(loudnessOf(sum / count) - 10.0);
+    sum = 0.0;
+    count = 0;
+    for (int bin = first; bin < kHistogramBins; ++bin) {
+        sum += momentaryHistogram[bin] * binPower[bin];
+        count += momentaryHistogram[bin];
+    }
+    if (count > 0) integrated = static_cast<float>(loudnessOf(sum / count));
+}
+
+void LoudnessMeter::updateRange() {
+    const auto& binPower = binMeanSquares();
+
+    double sum = 0.0;
+    uint64_t count = 0;
+    for (int bin = 0; bin < kHistogramBins; ++bin) {
+        sum += shortTermHistogram[bin] * binPower[bin];
+        count += shortTermHistogram[bin];
+    }
+    if (count == 0) return;
+
+    // Relative gate 20 LU down, then the 10th to 95th percentile spread
+    int first = firstBinAbove(loudnessOf(sum / count) - 20.0);
+    uint64_t gated = 0;
+    for (int bin = first; bin < kHistogramBins; ++bin) gated += shortTermHistogram[bin];
+    if (gated == 0) return;
+
+    auto percentile = [&](double p) {
+        uint64_t target = static_cast<uint64_t>(p * (gated - 1));
+        uint64_t seen = 0;
+        for (int bin = first; bin < kHistogramBins; ++bin) {
+            seen += shortTermHistogram[bin];
+            if (seen > target) return binCenter(bin);
+        }
+        return binCenter(kHistogramBins - 1);
+    };
+    range = static_cast<float>(percentile(0.95) - percentile(0.10));
+}
@@ -0,0 +1,60 @@
+#include "NoiseFloor.h"
+#include "DspKernels.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    // Smoothing before the minimum search, short enough to follow level changes
+    constexpr float kSmoothingTime = 0.1f;
+
+    // The minimum of a smoothed noise periodogram sits below its mean
+    constexpr float kBias = 1.5f;
+}
+
+NoiseFloor::NoiseFloor(int numBands, float windowSeconds, float maxFloor)
+    : numBands(numBands), subWindowTime(std::max(windowSeconds, 0.01f) / kSubWindows),
+      maxFloor(maxFloor) {
+    smoothed.resize(numBands, 0.0f);
+    currentMin.resize(numBands, 0.0f);
+    subMins.resize(static_cast<size_t>(kSubWindows) * numBands, 0.0f);
+    windowMin.resize(numBands, 0.0f);
+    floor.resize(numBands, 0.0f);
+}
+
+void NoiseFloor::update(const float* power, float dt) {
+    if (!primed) {
+        // Every minimum starts at the first frame
+        std::copy(power, power + numBands, smoothed.begin());
+        std::copy(power, power + numBands, currentMin.begin());
+        std::copy(power, power + numBands, windowMin.begin());
+        for (int sub = 0; sub < kSubWindows; ++sub) {
+            std::copy(power, power + numBands, subMins.begin() + static_cast<size_t>(sub) * numBands);
+        }
+        primed = true;
+    } else {
+        float alpha = 1.0f - std::exp(-dt / kSmoothingTime);
+        for (int band = 0; band < numBands; ++band) {
+            smoothed[band] += (power[band] - smoothed[band]) * alpha;
+        }
+        dsp::minInto(currentMin.data(), smoothed.data(), numBands);
+    }
+
+    // Sub-window done: it replaces the oldest one and the window minimum is rebuilt
+    subElapsed += dt;
+    if (subElapsed >= subWindowTime) {
+        subElapsed = 0.0f;
+        std::copy(currentMin.begin(), currentMin.end(),
+                  subMins.begin() + static_cast<size_t>(subIndex) * numBands);
+        subIndex = (subIndex + 1) % kSubWindows;
+
+        std::copy(subMins.begin(), subMins.begin() + numBands, windowMin.begin());
+        for (int sub = 1; sub < kSubWindows; ++sub) {
+            dsp::minInto(windowMin.data(), subMins.data() + static_cast<size_t>(sub) * numBands, numBands);
+        }
+        currentMin = smoothed;
+    }
+
+    for (int band = 0; band < numBands; ++band) {
+        floor[band] = std::min(std::min(windowMin[band], currentMin[band]) * kBias, maxFloor);
+    }
+}
@@ -0,0 +1,89 @@
+#include "P2Quantile.h"
+#include <algorithm>
+
+P2Quantile::P2Quantile(float quantile)
+    : p(quantile) {
+    reset();
+}
+
+void P2Quantile::reset() {
+    count = 0;
+    for (int i = 0; i < 5; ++i) positions[i] = static_cast<float>(i);
+    desired[0] = 0.0f;
+    desired[1] = 2.0f * p;
+    desired[2] = 4.0f * p;
+    desired[3] = 2.0f + 2.0f * p;
+    desired[4] = 4.0f;
+    increments[0] = 0.0f;
+    increments[1] = p / 2.0f;
+    increments[2] = p;
+    increments[3] = (1.0f + p) / 2.0f;
+    increments[4] = 1.0f;
+}
+
+void P2Quantile::add(float x) {
+    if (count < 5) {
+        // Insertion into the first five markers keeps them ordered
+        int i = static_cast<int>(count++);
+        while (i > 0 && heights[i - 1] > x) {
+            heights[i] = heights[i - 1];
+            --i;
+        }
+        heights[i] = x;
+        return;
+    }
+    ++count;
+
+    // Cell of the new sample, extending the extremes if needed
+    int k;
+    if (x < heights[0]) {
+        heights[0] = x;
+        k = 0;
+    } else if (x >= heights[4]) {
+        heights[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (x >= heights[k + 1]) ++k;
+    }
+
+    for (int i = k + 1; i < 5; ++i) positions[i] += 1.0f;
+    for (int i = 0; i < 5; ++i) desired[i] += increments[i];
+
+    // Move the middle markers back towards their desired positions
+    for (int i = 1; i < 4; ++i) {
+        float d = desired[i] - positions[i];
+        if ((d >= 1.0f && positions[i + 1] - positions[i] > 1.0f) ||
+            (d <= -1.0f && positions[i - 1] - positions[i] < -1.0f)) {
+            int step = d > 0.0f ? 1 : -1;
+            float candidate = parabolic(i, step);
+            if (heights[i - 1] < candidate && candidate < heights[i + 1]) {
+                heights[i] = candidate;
+            } else {
+                heights[i] = linear(i, step);
+            }
+            positions[i] += step;
+        }
+    }
+}
+
+float P2Quantile::parabolic(int i, int d) const {
+    const float* q = heights;
+    const float* n = positions;
+    return q[i] + d / (n[i + 1] - n[i - 1]) *
+        ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+         (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+float P2Quantile::linear(int i, int d) const {
+    return heights[i] + d * (heights[i + d] - heights[i]) / (positions[i + d] - positions[i]);
+}
+
+float P2Quantile::getEstimate() const {
+    if (count >= 5) return heights[2];
+    if (count == 0) return 0.0f;
+
+    // Few samples: nearest rank in the sorted start
+    int rank = static_cast<int>(p * (count - 1) + 0.5f);
+    return heights[std::clamp(rank, 0, static_cast<int>(count) - 1)];
+}
@@ -0,0 +1,99 @@
+#include "PartitionedConvolver.h"
+#include <algorithm>
+#include <cstring>
+
+PartitionedConvolver::PartitionedConvolver(const float* filter, size_t length, int blockSize,
+                                           unsigned planFlags)
+    : blockSize(blockSize), fftSize(2 * blockSize), numBins(blockSize + 1), filterLength(length) {
+    numPartitions = std::max(1, static_cast<int>((length + blockSize - 1) / blockSize));
+
+    partitions = fftwf_alloc_complex(static_cast<size_t>(numPartitions) * numBins);
+    delayLine = fftwf_alloc_complex(static_cast<size_t>(numPartitions) * numBins);
+    spectrum = fftwf_alloc_complex(numBins);
+    accumulator = fftwf_alloc_complex(numBins);
+    timeBuffer = fftwf_alloc_real(fftSize);
+    outputBuffer = fftwf_alloc_real(fftSize);
+    forwardPlan = fftwf_plan_dft_r2c_1d(fftSize, timeBuffer, spectrum, planFlags);
+    inversePlan = fftwf_plan_dft_c2r_1d(fftSize, accumulator, outputBuffer, planFlags);
+
+    // Each partition zero padded to the FFT size
+    const float scale = 1.0f / fftSize;
+    for (int k = 0; k < numPartitions; ++k) {
+        size_t first = static_cast<size_t>(k) * blockSize;
+        size_t count = std::min(static_cast<size_t>(blockSize), length - std::min(length, first));
+        std::fill(timeBuffer, timeBuffer + fftSize, 0.0f);
+        std::copy(filter + first, filter + first + count, timeBuffer);
+        fftwf_execute(forwardPlan);
+
+        fftwf_complex* H = partitions + static_cast<size_t>(k) * numBins;
+        for (int bin = 0; bin < numBins; ++bin) {
+            H[bin][0] = spectrum[bin][0] * scale;
+            H[bin][1] = spectrum[bin][1] * scale;
+        }
+    }
+
+    reset();
+}
+
+PartitionedConvolver::~PartitionedConvolver() {
+    fftwf_destroy_plan(forwardPlan);
+    fftwf_destroy_plan(inversePlan);
+    fftwf_free(partitions);
+    fftwf_free(delayLine);
+    fftwf_free(spectrum);
+    fftwf_free(accumulator);
+    fftwf_free(timeBuffer);
+    fftwf_free(outputBuffer);
+}
+
+void PartitionedConvolver::reset() {
+    std::fill(timeBuffer, timeBuffer + fftSize, 0.0f);
+    std::fill(&delayLine[0][0], &delayLine[0][0] + 2 * static_cast<size_t>(numPartitions) * numBins, 0.0f);
+    delayPos = 0;
+}
+
+void PartitionedConvolver::process(const float* in, float* out) {
+    // Slide the input window by one block
+    std::memmove(timeBuffer, timeBuffer + blockSize, blockSize * sizeof(float));
+    std::memcpy(timeBuffer + blockSize, in, blockSize * sizeof(float));
+    fftwf_execute(forwardPlan);
+
+    delayPos = (delayPos + 1) % numPartitions;
+    std::memcpy(delayLine + static_cast<size_t>(delayPos) * numBins, spectrum, numBins * sizeof(fftwf_complex));
+
+    // Y = sum over k of X[now - k] * H[k]
+    std::fill(&accumulator[0][0], &accumulator[0][0] + 2 * numBins, 0.0f);
+    for (int k = 0; k < numPartitions; ++k) {
+        int slot = (delayPos - k + numPartitions) % numPartitions;
+        const fftwf_complex* X = delayLine + static_cast<size_t>(slot) * numBins;
+        const fftwf_complex* H = partitions + static_cast<size_t>(k) * numBins;
+        for (int bin = 0; bin < numBins; ++bin) {
+            accumulator[bin][0] += X[bin][0] * H[bin][0] - X[bin][1] * H[bin][1];
+            accumulator[bin][1] += X[bin][0] * H[bin][1] + X[bin][1] * H[bin][0];
+        }
+    }
+
+    // The second half is free of circular wrap
+    fftwf_execute(inversePlan);
+    std::memcpy(out, outputBuffer + blockSize, blockSize * sizeof(float));
+}
+
+std::vector<float> PartitionedConvolver::convolve(const float* input, size_t n) {
+    reset();
+
+    const size_t outputLength = n + filterLength - 1;
+    const size_t numBlocks = (outputLength + blockSize - 1) / blockSize;
+    std::vector<float> output(numBlocks * blockSize);
+    std::vector<float> block(blockSize);
+
+    for (size_t b = 0; b < numBlocks; ++b) {
+        size_t first = b * blockSize;
+        size_t count = first < n ? std::min(static_cast<size_t>(blockSize), n - first) : 0;
+        std::copy(input + first, input + first + count, block.begin());
+        std::fill(block.begin() + count, block.end(), 0.0f);
+        process(block.data(), output.data() + first);
+    }
+
+    output.resize(outputLength);
+    return output;
+}
@@ -0,0 +1,35 @@
+#include "PeakFinder.h"
+#include <cmath>
+
+PeakFinder::PeakFinder(int maxPeaks, float threshold)
+    : maxPeaks(maxPeaks), threshold(threshold) {
+    heap.reserve(maxPeaks);
+    peaks.reserve(maxPeaks);
+}
+
+void PeakFinder::offerRange(const float* mag, int first, int last) {
+    for (int bin = first; bin < last; ++bin) {
+        offer(mag, bin);
+    }
+}
+
+void PeakFinder::finish(const float* mag, float binStartFreq, float binWidth) {
+    peaks.clear();
+    for (const auto& candidate : heap) {
+        const int bin = candidate.bin;
+        float a = std::log(mag[bin - 1] + 1e-20f);
+        float b = std::log(mag[bin] + 1e-20f);
+        float c = std::log(mag[bin + 1] + 1e-20f);
+
+        // Vertex of the parabola, exact for a Gaussian main lobe
+        float denom = a - 2.0f * b + c;
+        float offset = denom < 0.0f ? 0.5f * (a - c) / denom : 0.0f;
+        offset = std::clamp(offset, -0.5f, 0.5f);
+
+        peaks.push_back({binStartFreq + (bin + offset) * binWidth,
+                         std::exp(b - 0.25f * (a - c) * offset)});
+    }
+
+    std::sort(peaks.begin(), peaks.end(),
+              [](const Peak& x, const Peak& y) { return x.magnitude > y.magnitude; });
+}
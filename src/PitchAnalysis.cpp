@@ -0,0 +1,117 @@
+#include "PitchAnalysis.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    // YIN absolute threshold on the normalized difference
+    constexpr float kThreshold = 0.15f;
+
+    // Chroma covers A0 up to here
+    constexpr float kChromaMinFreq = 27.5f;
+    constexpr float kChromaMaxFreq = 5000.0f;
+}
+
+PitchDetector::PitchDetector(int frameSize, int sampleRate, float minFreq, float maxFreq)
+    : frameSize(frameSize), window(frameSize / 2), sampleRate(sampleRate) {
+
+    // Lags must fit the half frame that is not the integration window
+    minLag = std::max(2, static_cast<int>(sampleRate / maxFreq));
+    maxLag = std::min(window - 2, static_cast<int>(sampleRate / minFreq) + 1);
+
+    timeBuffer = fftwf_alloc_real(frameSize);
+    frameSpectrum = fftwf_alloc_complex(frameSize / 2 + 1);
+    headSpectrum = fftwf_alloc_complex(frameSize / 2 + 1);
+    forwardPlan = fftwf_plan_dft_r2c_1d(frameSize, timeBuffer, frameSpectrum, FFTW_MEASURE);
+    inversePlan = fftwf_plan_dft_c2r_1d(frameSize, frameSpectrum, timeBuffer, FFTW_MEASURE);
+
+    energy.resize(frameSize + 1, 0.0f);
+    difference.resize(maxLag + 2, 1.0f);
+}
+
+PitchDetector::~PitchDetector() {
+    fftwf_destroy_plan(forwardPlan);
+    fftwf_destroy_plan(inversePlan);
+    fftwf_free(timeBuffer);
+    fftwf_free(frameSpectrum);
+    fftwf_free(headSpectrum);
+}
+
+void PitchDetector::process(const float* frame) {
+    energy[0] = 0.0f;
+    for (int i = 0; i < frameSize; ++i) energy[i + 1] = energy[i] + frame[i] * frame[i];
+
+    pitch = 0.0f;
+    confidence = 0.0f;
+    if (energy[frameSize] < 1e-8f) return;
+
+    // r(tau) = sum over the window of x[j] * x[j + tau], as the circular
+    // cross-correlation of the zero padded head with the frame (no wrap for tau < window)
+    std::copy(frame, frame + window, timeBuffer);
+    std::fill(timeBuffer + window, timeBuffer + frameSize, 0.0f);
+    fftwf_execute_dft_r2c(forwardPlan, timeBuffer, headSpectrum);
+    std::copy(frame, frame + frameSize, timeBuffer);
+    fftwf_execute_dft_r2c(forwardPlan, timeBuffer, frameSpectrum);
+
+    const float scale = 1.0f / frameSize;
+    for (int k = 0; k <= frameSize / 2; ++k) {
+        float aRe = headSpectrum[k][0], aIm = -headSpectrum[k][1];
+        float bRe = frameSpectrum[k][0], bIm = frameSpectrum[k][1];
+        frameSpectrum[k][0] = (aRe * bRe - aIm * bIm) * scale;
+        frameSpectrum[k][1] = (aRe * bIm + aIm * bRe) * scale;
+    }
+    fftwf_execute_dft_c2r(inversePlan, frameSpectrum, timeBuffer);
+    const float* r = timeBuffer;
+
+    // d(tau) = E(0..W) + E(tau..tau+W) - 2 r(tau), then cumulative mean normalization
+    const float headEnergy = energy[window];
+    float runningSum = 0.0f;
+    difference[0] = 1.0f;
+    for (int tau = 1; tau <= maxLag + 1; ++tau) {
+        float d = std::max(0.0f, headEnergy + energy[tau + window] - energy[tau] - 2.0f * r[tau]);
+        runningSum += d;
+        difference[tau] = runningSum > 0.0f ? d * tau / runningSum : 1.0f;
+    }
+
+    // First dip under the threshold, followed down to its minimum
+    int best = -1;
+    for (int tau = minLag; tau <= maxLag; ++tau) {
+        if (difference[tau] < kThreshold) {
+            while (tau + 1 <= maxLag && difference[tau + 1] < difference[tau]) ++tau;
+            best = tau;
+            break;
+        }
+    }
+    if (best < 0) return;
+
+    float a = difference[best - 1], b = difference[best], c = difference[best + 1];
+    float denom = a - 2.0f * b + c;
+    float offset = denom > 0.0f ? std::clamp(0.5f * (a - c) / denom, -0.5f, 0.5f) : 0.0f;
+
+    pitch = sampleRate / (best + offset);
+    confidence = std::clamp(1.0f - b, 0.0f, 1.0f);
+}
+
+Chromagram::Chromagram(int numBins, float binStartFreq, float binWidth) {
+    // Bins narrower than half a semitone at their frequency: f * (2^(1/12) - 1) >= 2 * binWidth
+    const float minFreq = std::max(kChromaMinFreq, 2.0f * binWidth / (std::pow(2.0f, 1.0f / 12.0f) - 1.0f));
+    firstBin = std::clamp(static_cast<int>(std::ceil((minFreq - binStartFreq) / binWidth)), 0, numBins);
+    int lastBin = std::clamp(static_cast<int>((kChromaMaxFreq - binStartFreq) / binWidth), -1, numBins - 1);
+
+    for (int bin = firstBin; bin <= lastBin; ++bin) {
+        float freq = binStartFreq + bin * binWidth;
+        int semitone = static_cast<int>(std::lround(12.0f * std::log2(freq / 440.0f))) + 9;  // C = 0
+        pitchClass.push_back(((semitone % 12) + 12) % 12);
+    }
+}
+
+void Chromagram::process(const float* power) {
+    chroma.fill(0.0f);
+    for (size_t i = 0; i < pitchClass.size(); ++i) {
+        chroma[pitchClass[i]] += power[firstBin + i];
+    }
+
+    float peak = *std::max_element(chroma.begin(), chroma.end());
+    if (peak > 0.0f) {
+        for (float& value : chroma) value /= peak;
+    }
+}
@@ -0,0 +1,123 @@
+#include "ReassignedSpectrum.h"
+#include "FrequencyWeighting.h"
+#include <cmath>
+#include <algorithm>
+
+ReassignedSpectrum::ReassignedSpectrum(int fftSize, int sampleRate, int hop,
+                                       std::shared_ptr<const WindowFunction> window,
+                                       std::shared_ptr<const BandLayout> layout, FrequencyWeighting weighting)
+    : fftSize(fftSize), numBins(fftSize / 2), numBands(layout->getNumBands()),
+      hop(static_cast<float>(hop)), window(std::move(window)) {
+
+    // Central difference of the window and the window weighted by time from
+    // the frame center, both zero outside the frame
+    const float* h = this->window->data();
+    derivativeWindow.resize(fftSize);
+    rampWindow.resize(fftSize);
+    for (int n = 0; n < fftSize; ++n) {
+        float prev = n > 0 ? h[n - 1] : 0.0f;
+        float next = n + 1 < fftSize ? h[n + 1] : 0.0f;
+        derivativeWindow[n] = 0.5f * (next - prev);
+        rampWindow[n] = static_cast<float>(n - fftSize / 2) * h[n];
+    }
+
+    const int spectrumSize = fftSize / 2 + 1;
+    input = fftwf_alloc_real(2 * fftSize);
+    output = fftwf_alloc_complex(2 * spectrumSize);
+    plan = fftwf_plan_many_dft_r2c(1, &fftSize, 2, input, nullptr, 1, fftSize,
+                                   output, nullptr, 1, spectrumSize, FFTW_MEASURE);
+
+    // Cell c covers bins [c, c + 1) / kCellsPerBin and belongs to the band
+    // holding its center frequency
+    const int numCells = numBins * kCellsPerBin;
+    const float binWidth = static_cast<float>(sampleRate) / fftSize;
+    const auto& low = layout->getLow();
+    const auto& high = layout->getHigh();
+    cellStride = numCells + 2;
+    cellBands.assign(2 * cellStride, numBands);
+    cellGains.assign(2 * cellStride, 0.0f);
+    int band = 0;
+    for (int cell = 0; cell < numCells; ++cell) {
+        float freq = (cell + 0.5f) / kCellsPerBin * binWidth;
+        while (band < numBands && freq >= high[band]) ++band;
+        if (band == numBands) break;
+        if (freq < low[band]) continue;
+        float gain = frequencyWeightGain(weighting, freq);
+        cellBands[cell + 1] = band;
+        cellGains[cell + 1] = gain * gain;
+    }
+    for (int cell = 0; cell < cellStride; ++cell) {
+        cellBands[cellStride + cell] = cellBands[cell] + numBands + 1;
+        cellGains[cellStride + cell] = cellGains[cell];
+    }
+
+    slots.resize(numBins);
+    values.resize(numBins);
+    histogram.resize(2 * (numBands + 1));
+    carry.assign(numBands, 0.0f);
+    bandPower.assign(numBands, 0.0f);
+}
+
+ReassignedSpectrum::~ReassignedSpectrum() {
+    fftwf_destroy_plan(plan);
+    fftwf_free(input);
+    fftwf_free(output);
+}
+
+void ReassignedSpectrum::process(const float* frame, const fftwf_complex* spectrum, const float* power) {
+    const float* dh = derivativeWindow.data();
+    const float* th = rampWindow.data();
+    for (int n = 0; n < fftSize; ++n) {
+        input[n] = frame[n] * dh[n];
+        input[fftSize + n] = frame[n] * th[n];
+    }
+    fftwf_execute(plan);
+
+    // Cell and value of every bin first, branch-free with only contiguous
+    // loads and stores so it vectorizes; the table lookups and scatter-add
+    // are then a plain histogram pass.
+    //   frequency: bin - Im(X_dh * conj(X_h)) / |X_h|^2 * N / (2 pi)
+    //   time:      Re(X_th * conj(X_h)) / |X_h|^2 samples from the frame center
+    const float* x = spectrum[0];
+    const float* derivative = output[0];
+    const float* ramp = output[fftSize / 2 + 1];
+    const float binScale = static_cast<float>(fftSize) / (2.0f * static_cast<float>(M_PI));
+    const float maxCell = static_cast<float>(numBins * kCellsPerBin);
+    const float halfHop = 0.5f * hop;
+    const int nextOffset = numBands + 1;
+    const int nextCells = cellStride;
+    int* slot = slots.data();
+    float* value = values.data();
+    const int count = numBins;
+
+    for (int bin = 0; bin < count; ++bin) {
+        float re = x[2 * bin];
+        float im = x[2 * bin + 1];
+        float squared = re * re + im * im;
+        float inverse = squared > 1e-30f ? 1.0f / squared : 0.0f;
+
+        float shift = (derivative[2 * bin] * im - derivative[2 * bin + 1] * re) * inverse * binScale;
+        float time = (ramp[2 * bin] * re + ramp[2 * bin + 1] * im) * inverse;
+
+        float cell = (static_cast<float>(bin) + shift) * kCellsPerBin;
+        cell = std::clamp(cell, -1.0f, maxCell);
+        int index = static_cast<int>(cell + 1.0f);
+
+        // Earlier than this frame's share was already published; later goes to the next frame
+        slot[bin] = index + (time > halfHop ? nextCells : 0);
+        value[bin] = time < -halfHop ? 0.0f : power[bin];
+    }
+
+    std::fill(histogram.begin(), histogram.end(), 0.0f);
+    float* bins = histogram.data();
+    const int* bandOf = cellBands.data();
+    const float* gainOf = cellGains.data();
+    for (int bin = 0; bin < count; ++bin) {
+        bins[bandOf[slot[bin]]] += value[bin] * gainOf[slot[bin]];
+    }
+
+    for (int b = 0; b < numBands; ++b) {
+        bandPower[b] = histogram[b] + carry[b];
+        carry[b] = histogram[nextOffset + b];
+    }
+}
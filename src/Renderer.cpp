@@ -107,11 +107,25 @@ void Renderer::pollEvents() {
         } else if (event.type == SDL_EVENT_KEY_DOWN) {
             if (event.key.key == SDLK_ESCAPE || event.key.key == SDLK_Q) {
                 closeRequested = true;
+            } else if (!event.key.repeat) {
+                keyPresses.push_back(event.key.key);
             }
         }
     }
 }
 
+std::vector<SDL_Keycode> Renderer::takeKeyPresses() {
+    std::vector<SDL_Keycode> keys;
+    keys.swap(keyPresses);
+    return keys;
+}
+
+float Renderer::barStep(int numBands, float& barWidth) const {
+    float totalGap = (numBands - 1) * visConfig.barGap;
+    barWidth = (width - totalGap) / static_cast<float>(numBands);
+    return barWidth + visConfig.barGap;
+}
+
 void Renderer::renderSpectrum(const std::vector<float>& bands, const std::vector<float>& peaks, bool showPeaks) {
     if (bands.empty()) return;
 
@@ -119,8 +133,8 @@ void Renderer::renderSpectrum(const std::vector<float>& bands, const std::vector
     static float maxBandSeen = 0.0f;
 
     int numBands = static_cast<int>(bands.size());
-    float totalGap = (numBands - 1) * visConfig.barGap;
-    float barWidth = (width - totalGap) / static_cast<float>(numBands);
+    float barWidth;
+    float step = barStep(numBands, barWidth);
 
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
@@ -130,7 +144,7 @@ void Renderer::renderSpectrum(const std::vector<float>& bands, const std::vector
 
     for (int i = 0; i < numBands; ++i) {
         maxBandSeen = std::max(maxBandSeen, bands[i]);
-        float x = i * (barWidth + visConfig.barGap);
+        float x = i * step;
         float barHeight = bands[i] * height * 0.95f; // Leave 5% margin at top
 
         renderBar(x, 0, barWidth, barHeight, bands[i]);
@@ -148,6 +162,43 @@ void Renderer::renderSpectrum(const std::vector<float>& bands, const std::vector
     }
 }
 
+void Renderer::renderTrace(const std::vector<float>& levels, const std::array<uint8_t, 3>& color) {
+    if (levels.empty()) return;
+
+    int numBands = static_cast<int>(levels.size());
+    float barWidth;
+    float step = barStep(numBands, barWidth);
+
+    glColor3f(color[0] / 255.0f, color[1] / 255.0f, color[2] / 255.0f);
+    glLineWidth(2.0f);
+
+    glBegin(GL_LINE_STRIP);
+    for (int i = 0; i < numBands; ++i) {
+        glVertex2f(i * step + barWidth * 0.5f, levels[i] * height * 0.95f);
+    }
+    glEnd();
+}
+
+void Renderer::renderHighlight(int band, int numBands, const std::array<uint8_t, 3>& color) {
+    if (band < 0 || band >= numBands) return;
+
+    float barWidth;
+    float x = band * barStep(numBands, barWidth);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glColor4f(color[0] / 255.0f, color[1] / 255.0f, color[2] / 255.0f, 0.35f);
+
+    glBegin(GL_QUADS);
+    glVertex2f(x, 0);
+    glVertex2f(x + barWidth, 0);
+    glVertex2f(x + barWidth, height);
+    glVertex2f(x, height);
+    glEnd();
+
+    glDisable(GL_BLEND);
+}
+
 void Renderer::renderBar(float x, float y, float width, float height, float level) {
     if (visConfig.barGradient) {
         // Gradient from bottom to top
@@ -0,0 +1,77 @@
+#include "SpectrumAverager.h"
+#include <cmath>
+#include <algorithm>
+
+SpectrumAverager::SpectrumAverager(AveragingMode mode, int numBins, int numFrames, float timeConstant)
+    : mode(mode), numBins(numBins), numFrames(std::max(1, numFrames)), timeConstant(timeConstant) {
+    average.resize(numBins, 0.0f);
+    if (mode == AveragingMode::Linear) {
+        history.resize(static_cast<size_t>(this->numFrames) * numBins, 0.0f);
+        sum.resize(numBins, 0.0);
+    }
+}
+
+void SpectrumAverager::reset() {
+    std::fill(average.begin(), average.end(), 0.0f);
+    std::fill(history.begin(), history.end(), 0.0f);
+    std::fill(sum.begin(), sum.end(), 0.0);
+    historyPos = 0;
+    frameCount = 0;
+}
+
+void SpectrumAverager::update(const float* power, float dt) {
+    if (frozen || mode == AveragingMode::Off) return;
+
+    ++frameCount;
+    float* avg = average.data();
+
+    switch (mode) {
+        case AveragingMode::Linear: {
+            float* slot = history.data() + static_cast<size_t>(historyPos) * numBins;
+            double* acc = sum.data();
+            for (int i = 0; i < numBins; ++i) {
+                acc[i] += power[i] - slot[i];
+                slot[i] = power[i];
+            }
+
+            // Drop the rounding error the running sum picked up once per lap
+            if (++historyPos >= numFrames) {
+                historyPos = 0;
+                rebuildSum();
+            }
+
+            float scale = 1.0f / std::min<uint64_t>(frameCount, numFrames);
+            for (int i = 0; i < numBins; ++i) {
+                avg[i] = static_cast<float>(acc[i]) * scale;
+            }
+            break;
+        }
+        case AveragingMode::Exponential: {
+            // First frame seeds the average so it does not ramp up from silence
+            float alpha = frameCount == 1 ? 1.0f : 1.0f - std::exp(-dt / timeConstant);
+            for (int i = 0; i < numBins; ++i) {
+                avg[i] += (power[i] - avg[i]) * alpha;
+            }
+            break;
+        }
+        case AveragingMode::Infinite: {
+            float alpha = 1.0f / frameCount;
+            for (int i = 0; i < numBins; ++i) {
+                avg[i] += (power[i] - avg[i]) * alpha;
+            }
+            break;
+        }
+        case AveragingMode::Off:
+            break;
+    }
+}
+
+void SpectrumAverager::rebuildSum() {
+    std::fill(sum.begin(), sum.end(), 0.0);
+    for (int frame = 0; frame < numFrames; ++frame) {
+        const float* slot = history.data() + static_cast<size_t>(frame) * numBins;
+        for (int i = 0; i < numBins; ++i) {
+            sum[i] += slot[i];
+        }
+    }
+}
@@ -1,5 +1,8 @@
 #include "SpectrumMeter.h"
 #include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
 #include <thread>
 #include <chrono>
 
@@ -18,23 +21,23 @@ bool SpectrumMeter::initialize() {
     const auto& visConfig = config.getVisualization();
 
     // Create FFT analyzer
-    fftAnalyzer = std::make_unique<FFTAnalyzer>(
-        specConfig.fftSize,
-        specConfig.sampleRate,
-        specConfig.bands,
-        specConfig.minFreq,
-        specConfig.maxFreq,
-        specConfig.minDb,
-        specConfig.maxDb,
-        specConfig.noiseThreshold,
-        specConfig.freqWeighting,
-        specConfig.smoothing
-    );
+    fftAnalyzer = std::make_unique<FFTAnalyzer>(specConfig);
+
+    if (specConfig.features && !specConfig.featuresFile.empty()) {
+        featuresFile.open(specConfig.featuresFile);
+        if (featuresFile) {
+            featuresFile << "time,centroid,spread,flatness,rolloff,flux,crest" << std::endl;
+            featuresFile << std::fixed << std::setprecision(4);
+        } else {
+            std::cerr << "Failed to open features file: " << specConfig.featuresFile << std::endl;
+        }
+    }
 
     // Create audio capture
     audioCapture = std::make_unique<AudioCapture>(
         specConfig.sampleRate,
-        audioConfig.bufferSize
+        audioConfig.bufferSize,
+        audioConfig.captureSink
     );
 
     // Set audio callback
@@ -66,36 +69,66 @@ void SpectrumMeter::run() {
     const auto& specConfig = config.getSpectrum();
 
     // Main loop
-    using clock = std::chrono::high_resolution_clock;
-    auto lastFrame = clock::now();
+    auto lastFrame = Clock::now();
     const auto targetFrameTime = std::chrono::milliseconds(16); // ~60 FPS
 
     while (running.load() && !renderer->shouldClose()) {
-        auto frameStart = clock::now();
+        auto frameStart = Clock::now();
 
         // Poll events
         renderer->pollEvents();
+        handleKeys();
 
-        // Update peaks (linear decay for consistent fall time)
-        if (specConfig.peakHoldEnabled) {
-            // Linear decay: fall from 1.0 to 0.0 in exactly N seconds
-            // At 60 FPS: decay_amount = 1.0 / (fall_time * 60)
-            float framesPerSecond = 60.0f;
-            float decayAmount = 1.0f / (specConfig.peakFallTime * framesPerSecond);
-            fftAnalyzer->updatePeaks(decayAmount);
-        }
+        // Latest results, ballistics and peak hold already ran in the analysis thread
+        fftAnalyzer->getSnapshot(snapshot);
+        handleFeedbackEvents(frameStart);
+        exportFeatures();
 
         // Render
         renderer->clear();
         renderer->renderSpectrum(
-            fftAnalyzer->getBands(),
-            fftAnalyzer->getPeaks(),
+            snapshot.bands,
+            snapshot.peaks,
             specConfig.peakHoldEnabled
         );
+
+        // Overlays, reference at the back
+        const auto& visConfig = config.getVisualization();
+        for (size_t band = 0; band < feedbackUntil.size(); ++band) {
+            if (feedbackUntil[band] > frameStart) {
+                renderer->renderHighlight(static_cast<int>(band), static_cast<int>(snapshot.bands.size()),
+                                          visConfig.feedbackColor);
+            }
+        }
+        if (!snapshot.reference.empty()) {
+            renderer->renderTrace(snapshot.reference, visConfig.referenceColor);
+        }
+        if (!snapshot.minHold.empty()) {
+            renderer->renderTrace(snapshot.minHold, visConfig.minHoldColor);
+        }
+        if (!snapshot.maxHold.empty()) {
+            renderer->renderTrace(snapshot.maxHold, visConfig.maxHoldColor);
+        }
+        if (!snapshot.average.empty()) {
+            renderer->renderTrace(snapshot.average, visConfig.averageColor);
+        }
+        if (!snapshot.side.empty()) {
+            renderer->renderTrace(snapshot.side, visConfig.sideColor);
+        }
+        if (!snapshot.transferDb.empty()) {
+            renderTransfer();
+        }
         renderer->present();
 
+        if ((specConfig.loudness || specConfig.truePeak || specConfig.stereo || specConfig.transfer ||
+             specConfig.peakCount > 0 || specConfig.beats || specConfig.pitch || specConfig.chroma ||
+             specConfig.features || specConfig.harmonics) &&
+            ++meterPrintCount % 60 == 0) {
+            printMeters();
+        }
+
         // Frame timing
-        auto frameEnd = clock::now();
+        auto frameEnd = Clock::now();
         auto frameTime = frameEnd - frameStart;
 
         if (frameTime < targetFrameTime) {
@@ -108,6 +141,157 @@ void SpectrumMeter::run() {
     std::cout << "Main loop exited" << std::endl;
 }
 
+void SpectrumMeter::handleKeys() {
+    for (SDL_Keycode key : renderer->takeKeyPresses()) {
+        if (key == SDLK_R) {
+            fftAnalyzer->resetAverage();
+            fftAnalyzer->resetHolds();
+            fftAnalyzer->resetTransfer();
+            std::cout << "Average, holds and transfer function reset" << std::endl;
+        } else if (key == SDLK_F) {
+            bool frozen = !fftAnalyzer->isAverageFrozen();
+            fftAnalyzer->setAverageFrozen(frozen);
+            std::cout << (frozen ? "Average frozen" : "Average running") << std::endl;
+        } else if (key == SDLK_L) {
+            fftAnalyzer->resetLoudness();
+            std::cout << "Loudness and true peak reset" << std::endl;
+        } else if (key == SDLK_SPACE) {
+            fftAnalyzer->captureReference();
+            std::cout << "Reference captured" << std::endl;
+        } else if (key == SDLK_C) {
+            fftAnalyzer->clearReference();
+            std::cout << "Reference cleared" << std::endl;
+        }
+    }
+}
+
+void SpectrumMeter::handleFeedbackEvents(Clock::time_point now) {
+    // Highlight stays up a while after the report
+    constexpr auto kHighlightTime = std::chrono::seconds(2);
+
+    FeedbackEvent event;
+    while (fftAnalyzer->popFeedbackEvent(event)) {
+        std::cout << std::fixed << std::setprecision(1)
+                  << "FEEDBACK " << event.frequency << " Hz, " << event.levelDb << " dBFS, "
+                  << event.ratioDb << " dB over neighbours, " << event.growth << " dB/s at "
+                  << event.timestamp << " s" << std::defaultfloat << std::endl;
+
+        if (event.band >= 0) {
+            feedbackUntil.resize(snapshot.bands.size(), Clock::time_point{});
+            if (event.band < static_cast<int>(feedbackUntil.size())) {
+                feedbackUntil[event.band] = now + kHighlightTime;
+            }
+        }
+    }
+}
+
+void SpectrumMeter::exportFeatures() {
+    if (!featuresFile.is_open()) return;
+
+    // Drains every frame analyzed since the last render frame
+    SpectralFeatureFrame frame;
+    while (fftAnalyzer->popFeatureFrame(frame)) {
+        featuresFile << frame.timestamp << "," << frame.centroid << "," << frame.spread << ","
+                     << frame.flatness << "," << frame.rolloff << "," << frame.flux << ","
+                     << frame.crest << "\n";
+    }
+}
+
+void SpectrumMeter::renderTransfer() {
+    const auto& visConfig = config.getVisualization();
+
+    // 0 dB at mid-screen, +-kTransferSpan/2 to the edges
+    constexpr float kTransferSpan = 60.0f;
+    transferLevels.resize(snapshot.transferDb.size());
+    for (size_t band = 0; band < transferLevels.size(); ++band) {
+        transferLevels[band] = std::clamp(0.5f + snapshot.transferDb[band] / kTransferSpan, 0.0f, 1.0f);
+    }
+
+    renderer->renderTrace(snapshot.coherence, visConfig.coherenceColor);
+    renderer->renderTrace(transferLevels, visConfig.transferColor);
+}
+
+void SpectrumMeter::printPitch() const {
+    if (snapshot.pitch <= 0.0f) {
+        std::cout << "Pitch: -" << std::endl;
+        return;
+    }
+
+    // Nearest equal-tempered note, A4 = 440 Hz
+    static const char* names[12] = {"A", "A#", "B", "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#"};
+    float semitones = 12.0f * std::log2(snapshot.pitch / 440.0f);
+    int note = static_cast<int>(std::lround(semitones));
+    int cents = static_cast<int>(std::lround((semitones - note) * 100.0f));
+    int octave = 4 + static_cast<int>(std::floor((note + 9) / 12.0f));
+
+    std::cout << "Pitch: " << snapshot.pitch << " Hz " << names[((note % 12) + 12) % 12] << octave
+              << (cents >= 0 ? " +" : " ") << cents << " cents, confidence "
+              << snapshot.pitchConfidence << std::endl;
+}
+
+void SpectrumMeter::printMeters() const {
+    const auto& specConfig = config.getSpectrum();
+    std::cout << std::fixed << std::setprecision(1);
+    if (specConfig.loudness) {
+        std::cout << "Loudness: M " << snapshot.momentaryLoudness
+                  << " S " << snapshot.shortTermLoudness
+                  << " I " << snapshot.integratedLoudness << " LUFS, LRA "
+                  << snapshot.loudnessRange << " LU" << std::endl;
+    }
+    if (specConfig.truePeak) {
+        std::cout << "True peak: L " << snapshot.maxTruePeak[0] << " R " << snapshot.maxTruePeak[1]
+                  << " dBTP, overs " << snapshot.truePeakOvers[0] << "/" << snapshot.truePeakOvers[1]
+                  << std::endl;
+    }
+    if (specConfig.transfer) {
+        std::cout << "Transfer function delay: " << snapshot.transferDelay << " samples" << std::endl;
+    }
+    if (specConfig.pitch) {
+        printPitch();
+    }
+    if (specConfig.chroma) {
+        static const char* names[12] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+        int strongest = static_cast<int>(std::max_element(snapshot.chroma.begin(), snapshot.chroma.end())
+                                         - snapshot.chroma.begin());
+        std::cout << "Chroma: strongest " << names[strongest] << std::endl;
+    }
+    if (specConfig.features) {
+        const auto& f = snapshot.features;
+        std::cout << "Features: centroid " << f.centroid << " Hz, spread " << f.spread
+                  << " Hz, rolloff " << f.rolloff << " Hz, crest " << f.crest << " dB, flatness "
+                  << std::setprecision(3) << f.flatness << ", flux " << f.flux
+                  << std::setprecision(1) << std::endl;
+    }
+    if (specConfig.harmonics && snapshot.fundamental > 0.0f && !snapshot.harmonicsResolved) {
+        std::cout << "Harmonics: " << std::setprecision(2) << snapshot.fundamental << " Hz "
+                  << std::setprecision(1) << snapshot.fundamentalDb
+                  << " dBFS, harmonics unresolved (lobes overlap, raise fft_size)" << std::endl;
+    } else if (specConfig.harmonics && snapshot.fundamental > 0.0f) {
+        std::cout << "Harmonics: " << std::setprecision(2) << snapshot.fundamental << " Hz "
+                  << std::setprecision(1) << snapshot.fundamentalDb << " dBFS, THD "
+                  << std::setprecision(3) << 100.0f * snapshot.thd << "% THD+N " << 100.0f * snapshot.thdN
+                  << "% (" << std::setprecision(1) << 20.0f * std::log10(snapshot.thdN + 1e-9f) << " dB)";
+        for (size_t n = 0; n < snapshot.harmonicsDb.size(); ++n) {
+            std::cout << " H" << n + 2 << " " << snapshot.harmonicsDb[n];
+        }
+        std::cout << std::endl;
+    }
+    if (specConfig.beats) {
+        std::cout << "Tempo: " << snapshot.tempo << " BPM, onsets " << snapshot.onsetCount << std::endl;
+    }
+    if (!snapshot.spectralPeaks.empty()) {
+        std::cout << "Peaks:";
+        for (const auto& peak : snapshot.spectralPeaks) {
+            std::cout << " " << peak.frequency << " Hz " << peak.levelDb << " dB,";
+        }
+        std::cout << std::endl;
+    }
+    if (specConfig.stereo) {
+        std::cout << "Correlation: " << std::setprecision(2) << snapshot.correlation << std::endl;
+    }
+    std::cout << std::defaultfloat;
+}
+
 void SpectrumMeter::shutdown() {
     running.store(false);
 
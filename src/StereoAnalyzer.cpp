@@ -0,0 +1,90 @@
+#include "StereoAnalyzer.h"
+#include "DspKernels.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    // Correlation meter integration time
+    constexpr float kCorrelationTime = 0.3f;
+}
+
+StereoAnalyzer::StereoAnalyzer(int fftSize, int sampleRate, std::shared_ptr<const WindowFunction> window,
+                               std::shared_ptr<const BandLayout> layout)
+    : fftSize(fftSize), hopSeconds(static_cast<float>(fftSize / 2) / sampleRate),
+      window(std::move(window)), layout(std::move(layout)) {
+
+    packed = fftwf_alloc_complex(fftSize);
+    fftPlan = fftwf_plan_dft_1d(fftSize, packed, packed, FFTW_FORWARD, FFTW_MEASURE);
+
+    const int numBins = fftSize / 2;
+    leftPower.resize(numBins, 0.0f);
+    rightPower.resize(numBins, 0.0f);
+    midPower.resize(numBins, 0.0f);
+    sidePower.resize(numBins, 0.0f);
+
+    const int numBands = this->layout->getNumBands();
+    mid.resize(numBands, 0.0f);
+    side.resize(numBands, 0.0f);
+    balance.resize(numBands, 0.0f);
+    scratch.resize(numBands, 0.0f);
+}
+
+StereoAnalyzer::~StereoAnalyzer() {
+    fftwf_destroy_plan(fftPlan);
+    fftwf_free(packed);
+}
+
+void StereoAnalyzer::analyze(const float* left, const float* right, fftwf_complex* midSpectrum) {
+    // Correlation of the unwindowed frame, smoothed like a hardware meter
+    float lr = dsp::dot(left, right, fftSize);
+    float ll = dsp::sumSquares(left, fftSize);
+    float rr = dsp::sumSquares(right, fftSize);
+    float frameCorrelation = ll > 1e-12f && rr > 1e-12f ? lr / std::sqrt(ll * rr) : 0.0f;
+    correlation += (frameCorrelation - correlation) * (1.0f - std::exp(-hopSeconds / kCorrelationTime));
+
+    const float* w = window->data();
+    for (int i = 0; i < fftSize; ++i) {
+        packed[i][0] = left[i] * w[i];
+        packed[i][1] = right[i] * w[i];
+    }
+    fftwf_execute(fftPlan);
+
+    // L[k] = (Z[k] + Z*[N-k]) / 2, R[k] = (Z[k] - Z*[N-k]) / 2j
+    const float powerScale = window->getPowerScale();
+    for (int bin = 0; bin < fftSize / 2; ++bin) {
+        const int mirror = (fftSize - bin) % fftSize;
+        float zRe = packed[bin][0], zIm = packed[bin][1];
+        float cRe = packed[mirror][0], cIm = -packed[mirror][1];
+
+        float lRe = 0.5f * (zRe + cRe), lIm = 0.5f * (zIm + cIm);
+        float rRe = 0.5f * (zIm - cIm), rIm = -0.5f * (zRe - cRe);
+        float mRe = 0.5f * (lRe + rRe), mIm = 0.5f * (lIm + rIm);
+        float sRe = 0.5f * (lRe - rRe), sIm = 0.5f * (lIm - rIm);
+        midSpectrum[bin][0] = mRe;
+        midSpectrum[bin][1] = mIm;
+
+        leftPower[bin] = (lRe * lRe + lIm * lIm) * powerScale;
+        rightPower[bin] = (rRe * rRe + rIm * rIm) * powerScale;
+        midPower[bin] = (mRe * mRe + mIm * mIm) * powerScale;
+        sidePower[bin] = (sRe * sRe + sIm * sIm) * powerScale;
+    }
+
+    // Nyquist bin is real in both channels: L = Re Z, R = Im Z
+    midSpectrum[fftSize / 2][0] = 0.5f * (packed[fftSize / 2][0] + packed[fftSize / 2][1]);
+    midSpectrum[fftSize / 2][1] = 0.0f;
+
+    const int numBands = layout->getNumBands();
+    layout->applyPower(midPower.data(), mid.data());
+    layout->applyPower(sidePower.data(), side.data());
+    for (int band = 0; band < numBands; ++band) {
+        mid[band] = std::sqrt(mid[band]);
+        side[band] = std::sqrt(side[band]);
+    }
+
+    layout->applyPower(leftPower.data(), scratch.data());
+    layout->applyPower(rightPower.data(), balance.data());
+    for (int band = 0; band < numBands; ++band) {
+        float total = scratch[band] + balance[band];
+        balance[band] = total > 1e-20f ? (balance[band] - scratch[band]) / total : 0.0f;
+    }
+}
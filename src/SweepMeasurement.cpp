@@ -0,0 +1,254 @@
+#include "SweepMeasurement.h"
+#include "PartitionedConvolver.h"
+#include "WavFile.h"
+#include <fftw3.h>
+#include <cmath>
+#include <complex>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+
+namespace {
+    // Convolution partition; the inverse filter is sweep-length, so large
+    // partitions keep the delay line short
+    constexpr int kBlockSize = 16384;
+
+    // Kept before the main peak of each impulse response; the low end of
+    // the band-limited impulse rings ahead of it
+    constexpr float kPreroll = 0.05f;
+
+    int nextPowerOfTwo(size_t n) {
+        int p = 1;
+        while (static_cast<size_t>(p) < n) p <<= 1;
+        return p;
+    }
+
+    // Spectrum of a real signal zero padded to size
+    std::vector<std::complex<float>> realSpectrum(const std::vector<float>& x, int size) {
+        float* in = fftwf_alloc_real(size);
+        fftwf_complex* out = fftwf_alloc_complex(size / 2 + 1);
+        fftwf_plan plan = fftwf_plan_dft_r2c_1d(size, in, out, FFTW_ESTIMATE);
+
+        size_t count = std::min(x.size(), static_cast<size_t>(size));
+        std::copy(x.begin(), x.begin() + count, in);
+        std::fill(in + count, in + size, 0.0f);
+        fftwf_execute(plan);
+
+        std::vector<std::complex<float>> result(size / 2 + 1);
+        for (int k = 0; k <= size / 2; ++k) result[k] = {out[k][0], out[k][1]};
+
+        fftwf_destroy_plan(plan);
+        fftwf_free(in);
+        fftwf_free(out);
+        return result;
+    }
+}
+
+SweepMeasurement::SweepMeasurement(const SweepConfig& config) : config(config) {
+    const double fs = config.sampleRate;
+    const double f1 = config.startFreq;
+    const double f2 = std::min(static_cast<double>(config.endFreq), 0.5 * fs);
+    const double T = config.duration;
+    rate = T / std::log(f2 / f1);
+
+    const size_t length = static_cast<size_t>(T * fs);
+    const size_t fadeLength = std::min(static_cast<size_t>(config.fade * fs), length / 2);
+    const float amplitude = std::pow(10.0f, config.level / 20.0f);
+
+    sweep.resize(length);
+    for (size_t n = 0; n < length; ++n) {
+        double t = n / fs;
+        double phase = 2.0 * M_PI * f1 * rate * (std::exp(t / rate) - 1.0);
+        double gain = 1.0;
+        if (n < fadeLength) {
+            gain = 0.5 - 0.5 * std::cos(M_PI * n / fadeLength);
+        } else if (n >= length - fadeLength) {
+            gain = 0.5 - 0.5 * std::cos(M_PI * (length - 1 - n) / fadeLength);
+        }
+        sweep[n] = static_cast<float>(amplitude * gain * std::sin(phase));
+    }
+
+    // Time reversed, -6 dB/octave from the high end so the product of the
+    // sweep's pink spectrum and the filter's is flat
+    inverse.resize(length);
+    for (size_t n = 0; n < length; ++n) {
+        inverse[n] = static_cast<float>(sweep[length - 1 - n] * std::exp(-(n / fs) / rate));
+    }
+    normalizeInverse();
+}
+
+void SweepMeasurement::normalizeInverse() {
+    // Unity gain through sweep and inverse, measured inside the band away
+    // from the fades
+    const int size = nextPowerOfTwo(2 * sweep.size());
+    auto X = realSpectrum(sweep, size);
+    auto F = realSpectrum(inverse, size);
+
+    const double binWidth = static_cast<double>(config.sampleRate) / size;
+    int first = static_cast<int>(2.0 * config.startFreq / binWidth);
+    int last = static_cast<int>(0.5 * std::min(config.endFreq, 0.5f * config.sampleRate) / binWidth);
+    double sum = 0.0;
+    for (int k = first; k <= last; ++k) sum += std::abs(X[k] * F[k]);
+    float gain = static_cast<float>((last - first + 1) / sum);
+
+    for (float& value : inverse) value *= gain;
+}
+
+std::vector<float> SweepMeasurement::generateSignal() const {
+    std::vector<float> signal(sweep);
+    signal.resize(sweep.size() + static_cast<size_t>(config.silence * config.sampleRate), 0.0f);
+    return signal;
+}
+
+bool SweepMeasurement::analyze(const float* recording, size_t numSamples) {
+    impulse.clear();
+    harmonicImpulses.clear();
+    etc.clear();
+    if (numSamples == 0) return false;
+
+    PartitionedConvolver convolver(inverse.data(), inverse.size(), kBlockSize, FFTW_ESTIMATE);
+    std::vector<float> result = convolver.convolve(recording, numSamples);
+
+    // The linear response peaks one sweep length after the sweep starts
+    size_t peak = 0;
+    float peakValue = 0.0f;
+    for (size_t i = 0; i < result.size(); ++i) {
+        float value = std::fabs(result[i]);
+        if (value > peakValue) {
+            peakValue = value;
+            peak = i;
+        }
+    }
+    if (peakValue <= 0.0f) {
+        std::cerr << "Sweep: recording is silent" << std::endl;
+        return false;
+    }
+    latency = static_cast<long>(peak) - static_cast<long>(inverse.size() - 1);
+
+    const double fs = config.sampleRate;
+    const long preroll = static_cast<long>(kPreroll * fs);
+    const long irLength = static_cast<long>(config.irLength * fs);
+
+    auto extract = [&](long start, long length) {
+        std::vector<float> segment;
+        if (start < 0 || length <= 0) return segment;
+        long end = std::min(start + length, static_cast<long>(result.size()));
+        segment.assign(result.begin() + start, result.begin() + end);
+        return segment;
+    };
+
+    impulse = extract(std::max(0L, static_cast<long>(peak) - preroll), irLength + preroll);
+
+    // Order k arrives L * ln(k) early, so higher orders come first. Each
+    // window runs forward from order k and stops where the window of order
+    // k - 1 begins (the fundamental, delay 0, for k = 2).
+    auto delayOf = [&](int k) { return static_cast<long>(std::lround(rate * std::log(k) * fs)); };
+    for (int k = 2; k <= config.harmonics; ++k) {
+        long gap = delayOf(k) - delayOf(k - 1);
+        long start = static_cast<long>(peak) - delayOf(k) - preroll;
+        std::vector<float> segment = extract(start, std::min(irLength, gap));
+        if (segment.empty()) break;
+        harmonicImpulses.push_back(std::move(segment));
+    }
+
+    computeEtc();
+
+    std::cout << "Sweep: latency " << latency << " samples (" << latency * 1000.0 / fs << " ms), peak "
+              << 20.0f * std::log10(peakValue) << " dB, " << harmonicImpulses.size()
+              << " harmonic responses" << std::endl;
+    return true;
+}
+
+void SweepMeasurement::computeEtc() {
+    // Envelope of the analytic signal: the Hilbert transform from the
+    // spectrum rotated by -90 degrees
+    const int size = nextPowerOfTwo(impulse.size());
+    float* time = fftwf_alloc_real(size);
+    fftwf_complex* freq = fftwf_alloc_complex(size / 2 + 1);
+    fftwf_plan forward = fftwf_plan_dft_r2c_1d(size, time, freq, FFTW_ESTIMATE);
+    fftwf_plan backward = fftwf_plan_dft_c2r_1d(size, freq, time, FFTW_ESTIMATE);
+
+    std::fill(time, time + size, 0.0f);
+    std::copy(impulse.begin(), impulse.end(), time);
+    fftwf_execute(forward);
+
+    for (int k = 0; k <= size / 2; ++k) {
+        float re = freq[k][0];
+        float im = freq[k][1];
+        bool edge = k == 0 || k == size / 2;
+        freq[k][0] = edge ? 0.0f : im / size;
+        freq[k][1] = edge ? 0.0f : -re / size;
+    }
+    fftwf_execute(backward);
+
+    etc.resize(impulse.size());
+    float maxEnergy = 0.0f;
+    for (size_t i = 0; i < impulse.size(); ++i) {
+        etc[i] = impulse[i] * impulse[i] + time[i] * time[i];
+        maxEnergy = std::max(maxEnergy, etc[i]);
+    }
+    for (float& value : etc) {
+        value = 10.0f * std::log10(value / maxEnergy + 1e-30f);
+    }
+
+    fftwf_destroy_plan(forward);
+    fftwf_destroy_plan(backward);
+    fftwf_free(time);
+    fftwf_free(freq);
+}
+
+bool SweepMeasurement::writeResults(const std::string& prefix) const {
+    const int fs = config.sampleRate;
+
+    if (!writeWav(prefix + "_ir.wav", {fs, 1, impulse})) return false;
+    for (size_t h = 0; h < harmonicImpulses.size(); ++h) {
+        if (!writeWav(prefix + "_h" + std::to_string(h + 2) + ".wav", {fs, 1, harmonicImpulses[h]})) return false;
+    }
+
+    // Harmonic k's spectrum at k * f is the distortion produced by excitation at f
+    const int size = nextPowerOfTwo(impulse.size());
+    const auto H1 = realSpectrum(impulse, size);
+    std::vector<std::vector<std::complex<float>>> Hk;
+    for (const auto& h : harmonicImpulses) Hk.push_back(realSpectrum(h, size));
+
+    std::ofstream response(prefix + "_response.csv");
+    if (!response) {
+        std::cerr << "Failed to create " << prefix << "_response.csv" << std::endl;
+        return false;
+    }
+    response << "frequency,magnitude_db,phase_deg";
+    for (size_t h = 0; h < Hk.size(); ++h) response << ",h" << h + 2 << "_dbc";
+    response << "\n" << std::fixed << std::setprecision(3);
+
+    const double binWidth = static_cast<double>(fs) / size;
+    for (int k = 1; k <= size / 2; ++k) {
+        double freq = k * binWidth;
+        if (freq < config.startFreq || freq > config.endFreq) continue;
+
+        float magnitude = std::abs(H1[k]) + 1e-20f;
+        response << freq << "," << 20.0f * std::log10(magnitude) << ","
+                 << std::arg(H1[k]) * 180.0 / M_PI;
+        for (size_t h = 0; h < Hk.size(); ++h) {
+            int bin = static_cast<int>(h + 2) * k;
+            response << ",";
+            if (bin <= size / 2) response << 20.0f * std::log10(std::abs(Hk[h][bin]) / magnitude + 1e-20f);
+        }
+        response << "\n";
+    }
+
+    std::ofstream etcFile(prefix + "_etc.csv");
+    if (!etcFile) {
+        std::cerr << "Failed to create " << prefix << "_etc.csv" << std::endl;
+        return false;
+    }
+    etcFile << "time_ms,level_db\n" << std::fixed << std::setprecision(3);
+    const long preroll = static_cast<long>(kPreroll * fs);
+    for (size_t i = 0; i < etc.size(); ++i) {
+        etcFile << (static_cast<long>(i) - preroll) * 1000.0 / fs << "," << etc[i] << "\n";
+    }
+
+    std::cout << "Sweep: wrote " << prefix << "_ir.wav, " << harmonicImpulses.size()
+              << " harmonic responses, " << prefix << "_response.csv and " << prefix << "_etc.csv" << std::endl;
+    return true;
+}
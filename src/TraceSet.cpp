@@ -0,0 +1,36 @@
+#include "TraceSet.h"
+#include "DspKernels.h"
+#include <algorithm>
+
+TraceSet::TraceSet(int numBands)
+    : numBands(numBands) {
+    maxHold.resize(numBands, 0.0f);
+    minHold.resize(numBands, 0.0f);
+}
+
+void TraceSet::update(const float* levels) {
+    if (!holdsValid) {
+        // Both holds start from the first frame after a reset
+        std::copy(levels, levels + numBands, maxHold.begin());
+        std::copy(levels, levels + numBands, minHold.begin());
+        holdsValid = true;
+        return;
+    }
+
+    dsp::maxInto(maxHold.data(), levels, numBands);
+    dsp::minInto(minHold.data(), levels, numBands);
+}
+
+void TraceSet::resetHolds() {
+    std::fill(maxHold.begin(), maxHold.end(), 0.0f);
+    std::fill(minHold.begin(), minHold.end(), 0.0f);
+    holdsValid = false;
+}
+
+void TraceSet::captureReference(const std::vector<float>& levels) {
+    reference = levels;
+}
+
+void TraceSet::clearReference() {
+    reference.clear();
+}
@@ -0,0 +1,206 @@
+#include "TransferAnalyzer.h"
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // Frames averaged between delay searches
+    constexpr int kDelaySearchFrames = 32;
+
+    // Normalized GCC-PHAT peak below which the lag is not trusted
+    constexpr float kMinPeak = 0.1f;
+}
+
+TransferAnalyzer::TransferAnalyzer(int fftSize, int sampleRate, std::shared_ptr<const WindowFunction> window,
+                                   std::shared_ptr<const BandLayout> layout, int referenceChannel,
+                                   float averageTime, bool autoDelay)
+    : fftSize(fftSize), autoDelay(autoDelay), referenceChannel(referenceChannel),
+      window(std::move(window)), layout(std::move(layout)) {
+
+    float hopSeconds = static_cast<float>(fftSize / 2) / sampleRate;
+    alpha = 1.0f - std::exp(-hopSeconds / std::max(averageTime, hopSeconds));
+
+    // Delays up to half a frame are measurable with GCC-PHAT on one frame
+    referenceLine.resize(fftSize, 0.0f);
+    measurementLine.resize(fftSize, 0.0f);
+    reference.resize(fftSize, 0.0f);
+    measurement.resize(fftSize, 0.0f);
+
+    packed = fftwf_alloc_complex(fftSize);
+    fftPlan = fftwf_plan_dft_1d(fftSize, packed, packed, FFTW_FORWARD, FFTW_MEASURE);
+    correlation = fftwf_alloc_complex(fftSize);
+    inversePlan = fftwf_plan_dft_1d(fftSize, correlation, correlation, FFTW_BACKWARD, FFTW_MEASURE);
+
+    const int numBins = fftSize / 2 + 1;
+    gxx.resize(numBins, 0.0f);
+    gyy.resize(numBins, 0.0f);
+    gxyRe.resize(numBins, 0.0f);
+    gxyIm.resize(numBins, 0.0f);
+
+    responsePower.resize(numBins, 0.0f);
+    coherentPower.resize(numBins, 0.0f);
+
+    const int numBands = this->layout->getNumBands();
+    bandGxx.resize(numBands, 0.0f);
+    bandGxyRe.resize(numBands, 0.0f);
+    bandGxyIm.resize(numBands, 0.0f);
+    bandResponsePower.resize(numBands, 0.0f);
+    bandCoherentPower.resize(numBands, 0.0f);
+    magnitudeDb.resize(numBands, 0.0f);
+    phase.resize(numBands, 0.0f);
+    coherence.resize(numBands, 0.0f);
+}
+
+TransferAnalyzer::~TransferAnalyzer() {
+    fftwf_destroy_plan(fftPlan);
+    fftwf_destroy_plan(inversePlan);
+    fftwf_free(packed);
+    fftwf_free(correlation);
+}
+
+void TransferAnalyzer::reset() {
+    std::fill(gxx.begin(), gxx.end(), 0.0f);
+    std::fill(gyy.begin(), gyy.end(), 0.0f);
+    std::fill(gxyRe.begin(), gxyRe.end(), 0.0f);
+    std::fill(gxyIm.begin(), gxyIm.end(), 0.0f);
+    framesAveraged = 0;
+    if (autoDelay) delay = 0;
+}
+
+void TransferAnalyzer::process(const float* samples, size_t frames) {
+    const size_t lineSize = referenceLine.size();
+
+    for (size_t i = 0; i < frames; ++i) {
+        referenceLine[linePos] = samples[2 * i + referenceChannel];
+        measurementLine[linePos] = samples[2 * i + 1 - referenceChannel];
+
+        // The delay can change at any frame, so it is read per sample
+        const size_t referenceDelay = std::max(delay, 0);
+        const size_t measurementDelay = std::max(-delay, 0);
+        reference[bufferPos] = referenceLine[(linePos + lineSize - referenceDelay) % lineSize];
+        measurement[bufferPos] = measurementLine[(linePos + lineSize - measurementDelay) % lineSize];
+        linePos = (linePos + 1) % lineSize;
+
+        if (++bufferPos >= static_cast<size_t>(fftSize)) {
+            analyze();
+            std::copy(reference.begin() + fftSize / 2, reference.end(), reference.begin());
+            std::copy(measurement.begin() + fftSize / 2, measurement.end(), measurement.begin());
+            bufferPos = fftSize / 2;
+        }
+    }
+}
+
+void TransferAnalyzer::analyze() {
+    // Both channels through one complex FFT, reference in the real part
+    const float* w = window->data();
+    for (int i = 0; i < fftSize; ++i) {
+        packed[i][0] = reference[i] * w[i];
+        packed[i][1] = measurement[i] * w[i];
+    }
+    fftwf_execute(fftPlan);
+
+    // First frame after a reset seeds the averages
+    const float a = framesAveraged == 0 ? 1.0f : alpha;
+    for (int bin = 0; bin <= fftSize / 2; ++bin) {
+        const int mirror = (fftSize - bin) % fftSize;
+        float zRe = packed[bin][0], zIm = packed[bin][1];
+        float cRe = packed[mirror][0], cIm = -packed[mirror][1];
+
+        float xRe = 0.5f * (zRe + cRe), xIm = 0.5f * (zIm + cIm);
+        float yRe = 0.5f * (zIm - cIm), yIm = -0.5f * (zRe - cRe);
+
+        // Gxy = conj(X) * Y
+        gxx[bin] += (xRe * xRe + xIm * xIm - gxx[bin]) * a;
+        gyy[bin] += (yRe * yRe + yIm * yIm - gyy[bin]) * a;
+        gxyRe[bin] += (xRe * yRe + xIm * yIm - gxyRe[bin]) * a;
+        gxyIm[bin] += (xRe * yIm - xIm * yRe - gxyIm[bin]) * a;
+    }
+    ++framesAveraged;
+
+    if (autoDelay && framesAveraged % kDelaySearchFrames == 0) {
+        estimateDelay();
+    }
+
+    updateBands();
+}
+
+void TransferAnalyzer::estimateDelay() {
+    // PHAT weighting keeps only the cross-spectrum phase, so the correlation
+    // peak is sharp whatever the spectrum of the excitation
+    const int half = fftSize / 2;
+    for (int bin = 0; bin <= half; ++bin) {
+        float norm = std::sqrt(gxyRe[bin] * gxyRe[bin] + gxyIm[bin] * gxyIm[bin]);
+        float re = norm > 1e-20f ? gxyRe[bin] / norm : 0.0f;
+        float im = norm > 1e-20f ? gxyIm[bin] / norm : 0.0f;
+        correlation[bin][0] = re;
+        correlation[bin][1] = im;
+        if (bin > 0 && bin < half) {
+            correlation[fftSize - bin][0] = re;
+            correlation[fftSize - bin][1] = -im;
+        }
+    }
+    fftwf_execute(inversePlan);
+
+    int peakIndex = 0;
+    float peak = 0.0f;
+    for (int i = 0; i < fftSize; ++i) {
+        if (correlation[i][0] > peak) {
+            peak = correlation[i][0];
+            peakIndex = i;
+        }
+    }
+
+    // Residual lag of the measurement channel after the current compensation
+    int lag = peakIndex < half ? peakIndex : peakIndex - fftSize;
+    if (peak / fftSize < kMinPeak || lag == 0) return;
+
+    int newDelay = std::clamp(delay + lag, -(half - 1), half - 1);
+    if (newDelay == delay) return;
+
+    std::cout << "Transfer function: delay " << newDelay << " samples" << std::endl;
+    delay = newDelay;
+
+    // Spectra averaged over the old alignment no longer apply, and neither
+    // does the half frame already buffered with it; framing restarts so the
+    // next average only holds frames taken with the new delay
+    std::fill(gxx.begin(), gxx.end(), 0.0f);
+    std::fill(gyy.begin(), gyy.end(), 0.0f);
+    std::fill(gxyRe.begin(), gxyRe.end(), 0.0f);
+    std::fill(gxyIm.begin(), gxyIm.end(), 0.0f);
+    framesAveraged = 0;
+    bufferPos = 0;
+}
+
+void TransferAnalyzer::updateBands() {
+    // Per-bin |H|^2 and coherence, each times Gxx so the band sums below are
+    // power-weighted means. Averaging per bin keeps phase rotation across a
+    // band (group delay) from cancelling in a band-summed Gxy.
+    //   Gxx * |H|^2 = |Gxy|^2 / Gxx,  Gxx * coherence = |Gxy|^2 / Gyy
+    const int numBins = fftSize / 2 + 1;
+    for (int bin = 0; bin < numBins; ++bin) {
+        float cross = gxyRe[bin] * gxyRe[bin] + gxyIm[bin] * gxyIm[bin];
+        responsePower[bin] = gxx[bin] > 1e-20f ? cross / gxx[bin] : 0.0f;
+        coherentPower[bin] = gyy[bin] > 1e-20f ? std::min(gxx[bin], cross / gyy[bin]) : 0.0f;
+    }
+
+    // Unweighted rows, so each band is a Gxx-weighted mean over its own bins
+    layout->applyPower(gxx.data(), bandGxx.data());
+    layout->applyPower(responsePower.data(), bandResponsePower.data());
+    layout->applyPower(coherentPower.data(), bandCoherentPower.data());
+    layout->applyPower(gxyRe.data(), bandGxyRe.data());
+    layout->applyPower(gxyIm.data(), bandGxyIm.data());
+
+    for (int band = 0; band < layout->getNumBands(); ++band) {
+        if (bandGxx[band] <= 1e-20f) {
+            magnitudeDb[band] = -120.0f;
+            phase[band] = 0.0f;
+            coherence[band] = 0.0f;
+            continue;
+        }
+
+        // H1 = Gxy / Gxx; the phase is that of the power-weighted mean of H
+        magnitudeDb[band] = 10.0f * std::log10(bandResponsePower[band] / bandGxx[band] + 1e-30f);
+        phase[band] = std::atan2(bandGxyIm[band], bandGxyRe[band]) * static_cast<float>(180.0 / M_PI);
+        coherence[band] = std::min(1.0f, bandCoherentPower[band] / bandGxx[band]);
+    }
+}
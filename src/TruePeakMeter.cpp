@@ -0,0 +1,74 @@
+#include "TruePeakMeter.h"
+#include <cmath>
+#include <algorithm>
+
+TruePeakMeter::TruePeakMeter(float overThresholdDb)
+    : overThreshold(std::pow(10.0f, overThresholdDb / 20.0f)) {
+
+    // Interpolation low-pass at the input Nyquist frequency: Blackman windowed
+    // sinc of 48 taps at the 4x rate, as long as the annex 2 example filter
+    constexpr int length = kTapsPerPhase * kFactor;
+    float prototype[length];
+    float sum = 0.0f;
+    for (int k = 0; k < length; ++k) {
+        double t = (k - (length - 1) / 2.0) / kFactor;
+        double sinc = t == 0.0 ? 1.0 : std::sin(M_PI * t) / (M_PI * t);
+        double w = 0.42 - 0.5 * std::cos(2.0 * M_PI * (k + 0.5) / length)
+                        + 0.08 * std::cos(4.0 * M_PI * (k + 0.5) / length);
+        prototype[k] = static_cast<float>(sinc * w);
+        sum += prototype[k];
+    }
+
+    // Phase p, tap t is prototype[t * kFactor + p]; unity gain per phase
+    for (int k = 0; k < length; ++k) {
+        coefficients[k] = prototype[k] * kFactor / sum;
+    }
+}
+
+void TruePeakMeter::reset() {
+    for (auto& channel : history) std::fill(std::begin(channel), std::end(channel), 0.0f);
+    historyPos = 0;
+    blockPeak.fill(0.0f);
+    maxPeak.fill(0.0f);
+    overs.fill(0);
+    inOver.fill(false);
+}
+
+void TruePeakMeter::startBlock() {
+    blockPeak.fill(0.0f);
+}
+
+void TruePeakMeter::process(const float* samples, size_t frames) {
+    const float* h = coefficients.data();
+
+    for (size_t i = 0; i < frames; ++i) {
+        historyPos = (historyPos + kTapsPerPhase - 1) % kTapsPerPhase;
+
+        for (int ch = 0; ch < kChannels; ++ch) {
+            float* line = history[ch];
+            float sample = samples[kChannels * i + ch];
+            line[historyPos] = sample;
+            line[historyPos + kTapsPerPhase] = sample;
+
+            // x[t] is the sample t steps back, all four phases per tap
+            const float* x = line + historyPos;
+            float acc[kFactor] = {};
+            for (int t = 0; t < kTapsPerPhase; ++t) {
+                for (int p = 0; p < kFactor; ++p) acc[p] += h[t * kFactor + p] * x[t];
+            }
+
+            float peak = 0.0f;
+            for (int p = 0; p < kFactor; ++p) peak = std::max(peak, std::fabs(acc[p]));
+
+            blockPeak[ch] = std::max(blockPeak[ch], peak);
+            maxPeak[ch] = std::max(maxPeak[ch], peak);
+
+            if (peak > overThreshold) {
+                if (!inOver[ch]) ++overs[ch];
+                inOver[ch] = true;
+            } else {
+                inOver[ch] = false;
+            }
+        }
+    }
+}
@@ -0,0 +1,165 @@
+#include "WavFile.h"
+#include <fstream>
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+    constexpr uint16_t kFormatPcm = 1;
+    constexpr uint16_t kFormatFloat = 3;
+    constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+    // WAV is little-endian regardless of the host
+    uint32_t le32(const unsigned char* p) {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    uint16_t le16(const unsigned char* p) {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    void put32(std::ofstream& file, uint32_t value) {
+        unsigned char bytes[4] = {static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8),
+                                  static_cast<unsigned char>(value >> 16), static_cast<unsigned char>(value >> 24)};
+        file.write(reinterpret_cast<const char*>(bytes), 4);
+    }
+
+    void put16(std::ofstream& file, uint16_t value) {
+        unsigned char bytes[2] = {static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8)};
+        file.write(reinterpret_cast<const char*>(bytes), 2);
+    }
+}
+
+bool readWav(const std::string& path, WavData& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return false;
+    }
+
+    unsigned char header[12];
+    if (!file.read(reinterpret_cast<char*>(header), 12) ||
+        std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0) {
+        std::cerr << path << " is not a WAV file" << std::endl;
+        return false;
+    }
+
+    uint16_t format = 0;
+    uint16_t bits = 0;
+    bool haveFormat = false;
+
+    unsigned char chunk[8];
+    while (file.read(reinterpret_cast<char*>(chunk), 8)) {
+        uint32_t size = le32(chunk + 4);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            std::vector<unsigned char> fmt(size);
+            if (size < 16 || !file.read(reinterpret_cast<char*>(fmt.data()), size)) break;
+            format = le16(&fmt[0]);
+            out.channels = le16(&fmt[2]);
+            out.sampleRate = static_cast<int>(le32(&fmt[4]));
+            bits = le16(&fmt[14]);
+            if (format == kFormatExtensible && size >= 26) {
+                format = le16(&fmt[24]);  // First two bytes of the subformat GUID
+            }
+            haveFormat = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!haveFormat || out.channels <= 0) break;
+
+            std::vector<unsigned char> data(size);
+            file.read(reinterpret_cast<char*>(data.data()), size);
+            data.resize(static_cast<size_t>(file.gcount()));  // Tolerate truncated recordings
+
+            const size_t bytes = bits / 8;
+            const size_t count = bytes > 0 ? data.size() / bytes : 0;
+            out.samples.resize(count);
+            const unsigned char* p = data.data();
+
+            if (format == kFormatPcm && bits == 16) {
+                for (size_t i = 0; i < count; ++i) {
+                    out.samples[i] = static_cast<int16_t>(le16(p + 2 * i)) / 32768.0f;
+                }
+            } else if (format == kFormatPcm && bits == 24) {
+                for (size_t i = 0; i < count; ++i) {
+                    const unsigned char* s = p + 3 * i;
+                    int32_t value = static_cast<int32_t>((s[0] << 8) | (s[1] << 16) | (static_cast<uint32_t>(s[2]) << 24));
+                    out.samples[i] = (value >> 8) / 8388608.0f;
+                }
+            } else if (format == kFormatPcm && bits == 32) {
+                for (size_t i = 0; i < count; ++i) {
+                    out.samples[i] = static_cast<float>(static_cast<int32_t>(le32(p + 4 * i)) / 2147483648.0);
+                }
+            } else if (format == kFormatFloat && bits == 32) {
+                for (size_t i = 0; i < count; ++i) {
+                    uint32_t word = le32(p + 4 * i);
+                    std::memcpy(&out.samples[i], &word, 4);
+                }
+            } else if (format == kFormatFloat && bits == 64) {
+                for (size_t i = 0; i < count; ++i) {
+                    uint64_t word = le32(p + 8 * i) | (static_cast<uint64_t>(le32(p + 8 * i + 4)) << 32);
+                    double value;
+                    std::memcpy(&value, &word, 8);
+                    out.samples[i] = static_cast<float>(value);
+                }
+            } else {
+                std::cerr << path << ": unsupported format " << format << " with " << bits << " bits" << std::endl;
+                return false;
+            }
+
+            out.samples.resize(out.frames() * out.channels);
+            return true;
+        } else {
+            // Chunks are padded to even sizes
+            file.seekg(size + (size & 1), std::ios::cur);
+        }
+    }
+
+    std::cerr << path << ": no audio data" << std::endl;
+    return false;
+}
+
+bool writeWav(const std::string& path, const WavData& data) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to create " << path << std::endl;
+        return false;
+    }
+
+    const uint32_t dataSize = static_cast<uint32_t>(data.samples.size() * 4);
+    const uint16_t blockAlign = static_cast<uint16_t>(data.channels * 4);
+
+    file.write("RIFF", 4);
+    put32(file, 4 + (8 + 18) + (8 + 4) + (8 + dataSize));
+    file.write("WAVE", 4);
+
+    file.write("fmt ", 4);
+    put32(file, 18);
+    put16(file, kFormatFloat);
+    put16(file, static_cast<uint16_t>(data.channels));
+    put32(file, static_cast<uint32_t>(data.sampleRate));
+    put32(file, static_cast<uint32_t>(data.sampleRate) * blockAlign);
+    put16(file, blockAlign);
+    put16(file, 32);
+    put16(file, 0);
+
+    // Required for non-PCM formats
+    file.write("fact", 4);
+    put32(file, 4);
+    put32(file, static_cast<uint32_t>(data.frames()));
+
+    file.write("data", 4);
+    put32(file, dataSize);
+    std::vector<unsigned char> bytes(dataSize);
+    for (size_t i = 0; i < data.samples.size(); ++i) {
+        uint32_t word;
+        std::memcpy(&word, &data.samples[i], 4);
+        for (int b = 0; b < 4; ++b) bytes[4 * i + b] = static_cast<unsigned char>(word >> (8 * b));
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), dataSize);
+
+    if (!file) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
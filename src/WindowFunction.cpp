@@ -0,0 +1,104 @@
+#include "WindowFunction.h"
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // Zeroth order modified Bessel function of the first kind
+    double besselI0(double x) {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 50; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1e-12) break;
+        }
+        return sum;
+    }
+
+    template <size_t Terms>
+    double cosineSum(const std::array<double, Terms>& a, double x) {
+        double w = 0.0;
+        double sign = 1.0;
+        for (size_t k = 0; k < Terms; ++k) {
+            w += sign * a[k] * std::cos(2.0 * M_PI * k * x);
+            sign = -sign;
+        }
+        return w;
+    }
+}
+
+std::shared_ptr<const WindowFunction> WindowFunction::get(WindowType type, int size, float param) {
+    using Key = std::tuple<WindowType, int, float>;
+    static std::mutex cacheMutex;
+    static std::map<Key, std::weak_ptr<const WindowFunction>> cache;
+
+    // Only Kaiser and Gaussian have a parameter
+    if (type != WindowType::Kaiser && type != WindowType::Gaussian) param = 0.0f;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    Key key{type, size, param};
+    if (auto cached = cache[key].lock()) {
+        return cached;
+    }
+
+    auto window = std::make_shared<const WindowFunction>(type, size, param);
+    cache[key] = window;
+    return window;
+}
+
+std::shared_ptr<const WindowFunction> WindowFunction::get(const SpectrumConfig& config, int size) {
+    float param = 0.0f;
+    if (config.window == WindowType::Kaiser) param = config.kaiserBeta;
+    if (config.window == WindowType::Gaussian) param = config.gaussianSigma;
+    return get(config.window, size, param);
+}
+
+WindowFunction::WindowFunction(WindowType type, int size, float param) : type(type) {
+    coefficients.resize(size);
+    double sum = 0.0;
+    double sumSquares = 0.0;
+
+    // Periodic (DFT-even) windows
+    for (int i = 0; i < size; ++i) {
+        double x = static_cast<double>(i) / size;
+        double w = 1.0;
+
+        switch (type) {
+            case WindowType::Hann:
+                w = cosineSum(windows::kHann, x);
+                break;
+            case WindowType::BlackmanHarris:
+                w = cosineSum(windows::kBlackmanHarris, x);
+                break;
+            case WindowType::FlatTop:
+                w = cosineSum(windows::kFlatTop, x);
+                break;
+            case WindowType::Kaiser: {
+                double r = 2.0 * x - 1.0;
+                w = besselI0(param * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(param);
+                break;
+            }
+            case WindowType::Gaussian: {
+                double r = (x - 0.5) / (0.5 * param);
+                w = std::exp(-0.5 * r * r);
+                break;
+            }
+        }
+
+        coefficients[i] = static_cast<float>(w);
+        sum += w;
+        sumSquares += w * w;
+    }
+
+    coherentGain = static_cast<float>(sum / size);
+    enbw = static_cast<float>(size * sumSquares / (sum * sum));
+    amplitudeScale = static_cast<float>(2.0 / sum);
+    powerScale = amplitudeScale * amplitudeScale / enbw;
+
+    std::cout << "Window: " << size << " points, coherent gain " << coherentGain
+              << ", ENBW " << enbw << " bins" << std::endl;
+}
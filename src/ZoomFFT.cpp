@@ -0,0 +1,166 @@
+#include "ZoomFFT.h"
+#include "DspKernels.h"
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // Longest decimation filter we are willing to run per output sample
+    constexpr int kMaxTaps = 4095;
+    // Transition width factor of a Blackman windowed-sinc (delta_f = k * fs / taps)
+    constexpr float kBlackmanTransition = 5.5f;
+
+    float outputRateFor(int sampleRate, float span) {
+        // Aliases fold into the passband only from above rate - span/2, so a rate
+        // of twice the span leaves a full span of transition band. For very narrow
+        // spans the filter length limits how sharp the transition can be.
+        float minTransition = kBlackmanTransition * sampleRate / kMaxTaps;
+        return std::max(2.0f * span, span + minTransition);
+    }
+}
+
+ZoomFFT::ZoomFFT(int sampleRate, float minFreq, float maxFreq, std::shared_ptr<const WindowFunction> window)
+    : sampleRate(sampleRate), fftSize(window->size()), window(std::move(window)) {
+
+    centerFreq = 0.5f * (minFreq + maxFreq);
+    decimation = std::max(1, decimationFor(sampleRate, minFreq, maxFreq));
+    outputRate = static_cast<float>(sampleRate) / decimation;
+
+    double step = -2.0 * M_PI * centerFreq / sampleRate;
+    stepRe = static_cast<float>(std::cos(step));
+    stepIm = static_cast<float>(std::sin(step));
+
+    designFilter(maxFreq - minFreq);
+
+    frameRe.resize(fftSize, 0.0f);
+    frameIm.resize(fftSize, 0.0f);
+    magnitudes.resize(fftSize, 0.0f);
+    power.resize(fftSize, 0.0f);
+
+    fftInput = fftwf_alloc_complex(fftSize);
+    fftOutput = fftwf_alloc_complex(fftSize);
+    fftPlan = fftwf_plan_dft_1d(fftSize, fftInput, fftOutput, FFTW_FORWARD, FFTW_MEASURE);
+
+    std::cout << "Zoom FFT initialized: " << minFreq << "-" << maxFreq << " Hz, decimation "
+              << decimation << ", " << taps.size() << " taps, resolution "
+              << getBinWidth() << " Hz" << std::endl;
+}
+
+ZoomFFT::~ZoomFFT() {
+    fftwf_destroy_plan(fftPlan);
+    fftwf_free(fftInput);
+    fftwf_free(fftOutput);
+}
+
+int ZoomFFT::decimationFor(int sampleRate, float minFreq, float maxFreq) {
+    float span = maxFreq - minFreq;
+    if (span <= 0.0f) return 1;
+    return static_cast<int>(sampleRate / outputRateFor(sampleRate, span));
+}
+
+void ZoomFFT::designFilter(float span) {
+    // Low-pass at half the output rate, long enough that the transition band
+    // ends before aliases can fold back into [-span/2, span/2]
+    float transition = std::max(outputRate - span, 1.0f);
+    int numTaps = static_cast<int>(std::ceil(kBlackmanTransition * sampleRate / transition));
+    numTaps = std::min(kMaxTaps, numTaps) | 1;
+
+    float cutoff = 0.5f / decimation;  // Normalized to the input rate
+    int center = numTaps / 2;
+    taps.resize(numTaps);
+
+    double gain = 0.0;
+    for (int i = 0; i < numTaps; ++i) {
+        double x = i - center;
+        double sinc = (x == 0.0) ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+        double phase = 2.0 * M_PI * i / (numTaps - 1);
+        double blackman = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+        taps[i] = static_cast<float>(sinc * blackman);
+        gain += taps[i];
+    }
+
+    // Unity gain at DC
+    for (auto& tap : taps) tap = static_cast<float>(tap / gain);
+
+    delayRe.assign(2 * numTaps, 0.0f);
+    delayIm.assign(2 * numTaps, 0.0f);
+}
+
+bool ZoomFFT::process(const float* samples, size_t count, size_t& consumed) {
+    const size_t numTaps = taps.size();
+
+    for (size_t i = 0; i < count; ++i) {
+        // Mix down to baseband
+        float x = samples[i];
+        delayRe[delayPos] = delayRe[delayPos + numTaps] = x * oscRe;
+        delayIm[delayPos] = delayIm[delayPos + numTaps] = x * oscIm;
+
+        float re = oscRe * stepRe - oscIm * stepIm;
+        oscIm = oscRe * stepIm + oscIm * stepRe;
+        oscRe = re;
+
+        // Pull the oscillator back onto the unit circle now and then
+        if (++renormCounter >= 1024) {
+            float norm = 1.0f / std::sqrt(oscRe * oscRe + oscIm * oscIm);
+            oscRe *= norm;
+            oscIm *= norm;
+            renormCounter = 0;
+        }
+
+        delayPos = (delayPos + 1) % numTaps;
+
+        // Only evaluate the filter for samples we keep
+        if (++decimationPhase >= decimation) {
+            decimationPhase = 0;
+            float outRe, outIm;
+            dsp::dot2(taps.data(), delayRe.data() + delayPos, delayIm.data() + delayPos,
+                      numTaps, outRe, outIm);
+            pushDecimated(outRe, outIm);
+
+            if (framePos >= static_cast<size_t>(fftSize)) {
+                computeSpectrum();
+
+                // Overlap: shift buffer by half
+                std::copy(frameRe.begin() + fftSize / 2, frameRe.end(), frameRe.begin());
+                std::copy(frameIm.begin() + fftSize / 2, frameIm.end(), frameIm.begin());
+                framePos = fftSize / 2;
+
+                consumed = i + 1;
+                return true;
+            }
+        }
+    }
+
+    consumed = count;
+    return false;
+}
+
+void ZoomFFT::pushDecimated(float re, float im) {
+    frameRe[framePos] = re;
+    frameIm[framePos] = im;
+    ++framePos;
+}
+
+void ZoomFFT::computeSpectrum() {
+    const float* w = window->data();
+    for (int i = 0; i < fftSize; ++i) {
+        fftInput[i][0] = frameRe[i] * w[i];
+        fftInput[i][1] = frameIm[i] * w[i];
+    }
+
+    fftwf_execute(fftPlan);
+
+    // fftshift so index 0 is the lowest frequency. A real tone of amplitude A
+    // becomes a complex tone of A/2 after mixing, the same as the positive half
+    // of a real FFT, so the window scales match the full-band path.
+    const float amplitudeScale = window->getAmplitudeScale();
+    const float powerScale = window->getPowerScale();
+    for (int k = 0; k < fftSize; ++k) {
+        int src = (k + fftSize / 2) % fftSize;
+        float real = fftOutput[src][0];
+        float imag = fftOutput[src][1];
+        float squared = real * real + imag * imag;
+        power[k] = squared * powerScale;
+        magnitudes[k] = std::sqrt(squared) * amplitudeScale;
+    }
+}
@@ -1,9 +1,18 @@
 #include "SpectrumMeter.h"
+#include "SweepMeasurement.h"
+#include "DecayAnalysis.h"
+#include "AudioCapture.h"
+#include "WavFile.h"
 #include "Config.h"
 #include <iostream>
+#include <iomanip>
 #include <signal.h>
 #include <filesystem>
 #include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <mutex>
 
 static SpectrumMeter* g_spectrumMeter = nullptr;
 
@@ -14,62 +23,226 @@ void signalHandler(int signal) {
     }
 }
 
-int main(int argc, char* argv[]) {
-    std::cout << "=== PipeSpectrum - FFT Spectrum Analyzer ===" << std::endl;
-    std::cout << "Press ESC or Q to quit" << std::endl << std::endl;
+// User config in ~/.config/pipespectrum/config.yml, created from the sample if missing
+static std::string defaultConfigFile() {
+    const char* home = std::getenv("HOME");
+    if (!home) {
+        return "config.yml";
+    }
 
-    // Load configuration
-    Config config;
-    std::string configFile;
-
-    if (argc > 1) {
-        // Use config file from command line argument
-        configFile = argv[1];
-    } else {
-        // Use user config in ~/.config/pipespectrum/config.yml
-        const char* home = std::getenv("HOME");
-        if (home) {
-            std::filesystem::path configDir = std::filesystem::path(home) / ".config" / "pipespectrum";
-            std::filesystem::path userConfig = configDir / "config.yml";
-            configFile = userConfig;
-
-            // Create config directory if it doesn't exist
-            if (!std::filesystem::exists(configDir)) {
-                std::filesystem::create_directories(configDir);
-                std::cout << "Created config directory: " << configDir << std::endl;
-            }
+    std::filesystem::path configDir = std::filesystem::path(home) / ".config" / "pipespectrum";
+    std::filesystem::path userConfig = configDir / "config.yml";
+
+    // Create config directory if it doesn't exist
+    if (!std::filesystem::exists(configDir)) {
+        std::filesystem::create_directories(configDir);
+        std::cout << "Created config directory: " << configDir << std::endl;
+    }
+
+    // Copy sample config if user config doesn't exist
+    if (!std::filesystem::exists(userConfig)) {
+        // Try to find sample config in standard installation paths
+        std::vector<std::filesystem::path> samplePaths = {
+            "/usr/share/pipespectrum/config.sample.yaml",
+            "/usr/local/share/pipespectrum/config.sample.yaml",
+            "../config.sample.yaml",  // For running from build directory
+            "config.sample.yaml"
+        };
 
-            // Copy sample config if user config doesn't exist
-            if (!std::filesystem::exists(userConfig)) {
-                // Try to find sample config in standard installation paths
-                std::vector<std::filesystem::path> samplePaths = {
-                    "/usr/share/pipespectrum/config.sample.yaml",
-                    "/usr/local/share/pipespectrum/config.sample.yaml",
-                    "../config.sample.yaml",  // For running from build directory
-                    "config.sample.yaml"
-                };
-
-                for (const auto& samplePath : samplePaths) {
-                    if (std::filesystem::exists(samplePath)) {
-                        try {
-                            std::filesystem::copy_file(samplePath, userConfig);
-                            std::cout << "Created config file from sample: " << userConfig << std::endl;
-                            break;
-                        } catch (const std::filesystem::filesystem_error& e) {
-                            std::cerr << "Failed to copy config: " << e.what() << std::endl;
-                        }
-                    }
+        for (const auto& samplePath : samplePaths) {
+            if (std::filesystem::exists(samplePath)) {
+                try {
+                    std::filesystem::copy_file(samplePath, userConfig);
+                    std::cout << "Created config file from sample: " << userConfig << std::endl;
+                    break;
+                } catch (const std::filesystem::filesystem_error& e) {
+                    std::cerr << "Failed to copy config: " << e.what() << std::endl;
                 }
             }
-        } else {
-            configFile = "config.yml";
         }
     }
 
+    return userConfig;
+}
+
+static void loadConfig(Config& config, const std::string& configFile) {
     if (!config.load(configFile)) {
         std::cerr << "Warning: Failed to load config file '" << configFile
                   << "', using defaults" << std::endl;
     }
+}
+
+// Waterfall and reverberation time of an impulse response, printed and written next to it
+static bool analyzeDecay(const std::vector<float>& impulse, int sampleRate, const DecayConfig& decayConfig,
+                         const std::string& prefix) {
+    if (impulse.empty()) {
+        std::cerr << "Impulse response is empty" << std::endl;
+        return false;
+    }
+    size_t start = findDirectSound(impulse);
+
+    CumulativeSpectralDecay csd(decayConfig, sampleRate);
+    csd.process(impulse, start);
+
+    ReverberationTime reverb(sampleRate);
+    reverb.process(impulse, start);
+
+    std::cout << std::fixed << std::setprecision(2) << "Band (Hz)   EDT (s)  T20 (s)  T30 (s)" << std::endl;
+    for (const auto& band : reverb.getBands()) {
+        std::cout << std::setw(9) << band.center << std::setw(9) << band.edt << std::setw(9) << band.t20
+                  << std::setw(9) << band.t30 << std::endl;
+    }
+    std::cout << std::defaultfloat;
+
+    if (!csd.write(prefix + "_csd.csv") || !reverb.write(prefix + "_rt60.csv")) {
+        return false;
+    }
+    std::cout << "Decay: wrote " << prefix << "_csd.csv (" << csd.getSlices().size() << " slices) and "
+              << prefix << "_rt60.csv" << std::endl;
+    return true;
+}
+
+static bool analyzeRecording(SweepMeasurement& measurement, const std::vector<float>& recording,
+                             const SweepConfig& sweepConfig, const DecayConfig& decayConfig,
+                             const std::string& prefix) {
+    auto start = std::chrono::steady_clock::now();
+    if (!measurement.analyze(recording.data(), recording.size())) {
+        return false;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double audio = static_cast<double>(recording.size()) / sweepConfig.sampleRate;
+    std::cout << "Sweep: analyzed " << audio << " s in " << elapsed << " s ("
+              << audio / elapsed << "x real time)" << std::endl;
+    return measurement.writeResults(prefix) &&
+           analyzeDecay(measurement.getImpulse(), sweepConfig.sampleRate, decayConfig, prefix);
+}
+
+// pipespectrum sweep generate|analyze|capture ...
+static int runSweep(int argc, char* argv[]) {
+    auto usage = [] {
+        std::cerr << "Usage:\n"
+                  << "  pipespectrum sweep generate <output.wav> [config]\n"
+                  << "  pipespectrum sweep analyze <recording.wav> <output prefix> [config]\n"
+                  << "  pipespectrum sweep capture <output prefix> [config]" << std::endl;
+        return 1;
+    };
+    if (argc < 4) return usage();
+
+    const std::string command = argv[2];
+    const int configArg = command == "analyze" ? 5 : 4;
+    Config config;
+    loadConfig(config, argc > configArg ? argv[configArg] : defaultConfigFile());
+    const SweepConfig& sweepConfig = config.getSweep();
+
+    SweepMeasurement measurement(sweepConfig);
+
+    if (command == "generate") {
+        WavData wav{sweepConfig.sampleRate, 1, measurement.generateSignal()};
+        if (!writeWav(argv[3], wav)) return 1;
+        std::cout << "Sweep: wrote " << argv[3] << ", " << sweepConfig.startFreq << " - "
+                  << sweepConfig.endFreq << " Hz in " << sweepConfig.duration << " s" << std::endl;
+        return 0;
+    }
+
+    if (command == "analyze") {
+        if (argc < 5) return usage();
+        WavData wav;
+        if (!readWav(argv[3], wav)) return 1;
+        if (wav.sampleRate != sweepConfig.sampleRate) {
+            std::cerr << argv[3] << " is " << wav.sampleRate << " Hz, sweep sample_rate is "
+                      << sweepConfig.sampleRate << " Hz" << std::endl;
+            return 1;
+        }
+        if (sweepConfig.channel < 0 || sweepConfig.channel >= wav.channels) {
+            std::cerr << argv[3] << " has no channel " << sweepConfig.channel << std::endl;
+            return 1;
+        }
+
+        std::vector<float> recording(wav.frames());
+        for (size_t i = 0; i < recording.size(); ++i) {
+            recording[i] = wav.samples[i * wav.channels + sweepConfig.channel];
+        }
+        return analyzeRecording(measurement, recording, sweepConfig, config.getDecay(), argv[4]) ? 0 : 1;
+    }
+
+    if (command == "capture") {
+        if (sweepConfig.channel < 0 || sweepConfig.channel > 1) {
+            std::cerr << "Capture is stereo, channel must be 0 or 1" << std::endl;
+            return 1;
+        }
+
+        // Room for starting the playback, the sweep and its decay
+        constexpr float kLeadIn = 2.0f;
+        const size_t needed = static_cast<size_t>(
+            (kLeadIn + sweepConfig.duration + sweepConfig.silence) * sweepConfig.sampleRate);
+
+        std::vector<float> recording;
+        recording.reserve(needed);
+        std::mutex recordingMutex;
+
+        AudioCapture capture(sweepConfig.sampleRate, config.getAudio().bufferSize, config.getAudio().captureSink);
+        capture.setCallback([&](const float* samples, size_t count) {
+            std::lock_guard<std::mutex> lock(recordingMutex);
+            for (size_t i = 0; i + 1 < count && recording.size() < needed; i += 2) {
+                recording.push_back(samples[i + sweepConfig.channel]);
+            }
+        });
+        if (!capture.initialize()) {
+            std::cerr << "Failed to initialize audio capture" << std::endl;
+            return 1;
+        }
+
+        std::cout << "Recording " << static_cast<float>(needed) / sweepConfig.sampleRate
+                  << " s, play the sweep now" << std::endl;
+        capture.start();
+        while (true) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            std::lock_guard<std::mutex> lock(recordingMutex);
+            if (recording.size() >= needed) break;
+        }
+        capture.stop();
+
+        return analyzeRecording(measurement, recording, sweepConfig, config.getDecay(), argv[3]) ? 0 : 1;
+    }
+
+    return usage();
+}
+
+// pipespectrum ir <ir.wav> <output prefix> [config]
+static int runImpulse(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Usage: pipespectrum ir <ir.wav> <output prefix> [config]" << std::endl;
+        return 1;
+    }
+
+    Config config;
+    loadConfig(config, argc > 4 ? argv[4] : defaultConfigFile());
+
+    WavData wav;
+    if (!readWav(argv[2], wav)) return 1;
+
+    // First channel only
+    std::vector<float> impulse(wav.frames());
+    for (size_t i = 0; i < impulse.size(); ++i) {
+        impulse[i] = wav.samples[i * wav.channels];
+    }
+    return analyzeDecay(impulse, wav.sampleRate, config.getDecay(), argv[3]) ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "sweep") == 0) {
+        return runSweep(argc, argv);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "ir") == 0) {
+        return runImpulse(argc, argv);
+    }
+
+    std::cout << "=== PipeSpectrum - FFT Spectrum Analyzer ===" << std::endl;
+    std::cout << "Press ESC or Q to quit" << std::endl << std::endl;
+
+    // Load configuration, from the command line argument or the user config
+    Config config;
+    loadConfig(config, argc > 1 ? argv[1] : defaultConfigFile());
 
     // Create spectrum meter
     SpectrumMeter spectrumMeter(config);